@@ -1,37 +1,27 @@
 #ifndef CLOCK_CUSTOM_H
 #define CLOCK_CUSTOM_H
 
+#include "AssetStore.h"
 #include <Arduino.h>
 
 // These symbols are generated from the files specified in platformio.ini under 'board_build.embed_files'
+// (converted from the JPEGs by tools/pack_images.py), with ASSET_STORE they are looked up in the assets partition
 // See https://docs.platformio.org/en/latest/platforms/espressif32.html#embedding-binary-data for more info
 
 // Choose either with or without holes here and remember to also adjust platformio.ini
 // *************************************************************************************
 
-extern const byte clock_custom_0_start[] asm("_binary_images_ClockWidget_custom_custom_0_jpg_start");
-extern const byte clock_custom_0_end[] asm("_binary_images_ClockWidget_custom_custom_0_jpg_end");
-extern const byte clock_custom_1_start[] asm("_binary_images_ClockWidget_custom_custom_1_jpg_start");
-extern const byte clock_custom_1_end[] asm("_binary_images_ClockWidget_custom_custom_1_jpg_end");
-extern const byte clock_custom_2_start[] asm("_binary_images_ClockWidget_custom_custom_2_jpg_start");
-extern const byte clock_custom_2_end[] asm("_binary_images_ClockWidget_custom_custom_2_jpg_end");
-extern const byte clock_custom_3_start[] asm("_binary_images_ClockWidget_custom_custom_3_jpg_start");
-extern const byte clock_custom_3_end[] asm("_binary_images_ClockWidget_custom_custom_3_jpg_end");
-extern const byte clock_custom_4_start[] asm("_binary_images_ClockWidget_custom_custom_4_jpg_start");
-extern const byte clock_custom_4_end[] asm("_binary_images_ClockWidget_custom_custom_4_jpg_end");
-extern const byte clock_custom_5_start[] asm("_binary_images_ClockWidget_custom_custom_5_jpg_start");
-extern const byte clock_custom_5_end[] asm("_binary_images_ClockWidget_custom_custom_5_jpg_end");
-extern const byte clock_custom_6_start[] asm("_binary_images_ClockWidget_custom_custom_6_jpg_start");
-extern const byte clock_custom_6_end[] asm("_binary_images_ClockWidget_custom_custom_6_jpg_end");
-extern const byte clock_custom_7_start[] asm("_binary_images_ClockWidget_custom_custom_7_jpg_start");
-extern const byte clock_custom_7_end[] asm("_binary_images_ClockWidget_custom_custom_7_jpg_end");
-extern const byte clock_custom_8_start[] asm("_binary_images_ClockWidget_custom_custom_8_jpg_start");
-extern const byte clock_custom_8_end[] asm("_binary_images_ClockWidget_custom_custom_8_jpg_end");
-extern const byte clock_custom_9_start[] asm("_binary_images_ClockWidget_custom_custom_9_jpg_start");
-extern const byte clock_custom_9_end[] asm("_binary_images_ClockWidget_custom_custom_9_jpg_end");
-extern const byte clock_custom_colon_off_start[] asm("_binary_images_ClockWidget_custom_custom_colon_off_jpg_start");
-extern const byte clock_custom_colon_off_end[] asm("_binary_images_ClockWidget_custom_custom_colon_off_jpg_end");
-extern const byte clock_custom_colon_on_start[] asm("_binary_images_ClockWidget_custom_custom_colon_on_jpg_start");
-extern const byte clock_custom_colon_on_end[] asm("_binary_images_ClockWidget_custom_custom_colon_on_jpg_end");
+EMBEDDED_ASSET(clock_custom_0, "images_packed_ClockWidget_custom_custom_0_pimg")
+EMBEDDED_ASSET(clock_custom_1, "images_packed_ClockWidget_custom_custom_1_pimg")
+EMBEDDED_ASSET(clock_custom_2, "images_packed_ClockWidget_custom_custom_2_pimg")
+EMBEDDED_ASSET(clock_custom_3, "images_packed_ClockWidget_custom_custom_3_pimg")
+EMBEDDED_ASSET(clock_custom_4, "images_packed_ClockWidget_custom_custom_4_pimg")
+EMBEDDED_ASSET(clock_custom_5, "images_packed_ClockWidget_custom_custom_5_pimg")
+EMBEDDED_ASSET(clock_custom_6, "images_packed_ClockWidget_custom_custom_6_pimg")
+EMBEDDED_ASSET(clock_custom_7, "images_packed_ClockWidget_custom_custom_7_pimg")
+EMBEDDED_ASSET(clock_custom_8, "images_packed_ClockWidget_custom_custom_8_pimg")
+EMBEDDED_ASSET(clock_custom_9, "images_packed_ClockWidget_custom_custom_9_pimg")
+EMBEDDED_ASSET(clock_custom_colon_off, "images_packed_ClockWidget_custom_custom_colon_off_pimg")
+EMBEDDED_ASSET(clock_custom_colon_on, "images_packed_ClockWidget_custom_custom_colon_on_pimg")
 
 #endif
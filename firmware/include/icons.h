@@ -1,40 +1,27 @@
 #ifndef ICONS_H
 #define ICONS_H
 
+#include "AssetStore.h"
 #include <Arduino.h>
 
 // These symbols are generated from the files specified in platformio.ini under 'board_build.embed_files'
+// (converted from the JPEGs by tools/pack_images.py), with ASSET_STORE they are looked up in the assets partition
 // See https://docs.platformio.org/en/latest/platforms/espressif32.html#embedding-binary-data for more info
 
-extern const byte moonCloudW_start[] asm("_binary_images_WeatherWidget_light_moonCloudW_jpg_start");
-extern const byte moonCloudW_end[] asm("_binary_images_WeatherWidget_light_moonCloudW_jpg_end");
-extern const byte sunCloudsW_start[] asm("_binary_images_WeatherWidget_light_sunCloudsW_jpg_start");
-extern const byte sunCloudsW_end[] asm("_binary_images_WeatherWidget_light_sunCloudsW_jpg_end");
-extern const byte sunW_start[] asm("_binary_images_WeatherWidget_light_sunW_jpg_start");
-extern const byte sunW_end[] asm("_binary_images_WeatherWidget_light_sunW_jpg_end");
-extern const byte moonW_start[] asm("_binary_images_WeatherWidget_light_moonW_jpg_start");
-extern const byte moonW_end[] asm("_binary_images_WeatherWidget_light_moonW_jpg_end");
-extern const byte snowW_start[] asm("_binary_images_WeatherWidget_light_snowW_jpg_start");
-extern const byte snowW_end[] asm("_binary_images_WeatherWidget_light_snowW_jpg_end");
-extern const byte rainW_start[] asm("_binary_images_WeatherWidget_light_rainW_jpg_start");
-extern const byte rainW_end[] asm("_binary_images_WeatherWidget_light_rainW_jpg_end");
-extern const byte cloudsW_start[] asm("_binary_images_WeatherWidget_light_cloudsW_jpg_start");
-extern const byte cloudsW_end[] asm("_binary_images_WeatherWidget_light_cloudsW_jpg_end");
-extern const byte moonCloudB_start[] asm("_binary_images_WeatherWidget_dark_moonCloudB_jpg_start");
-extern const byte moonCloudB_end[] asm("_binary_images_WeatherWidget_dark_moonCloudB_jpg_end");
-extern const byte sunCloudsB_start[] asm("_binary_images_WeatherWidget_dark_sunCloudsB_jpg_start");
-extern const byte sunCloudsB_end[] asm("_binary_images_WeatherWidget_dark_sunCloudsB_jpg_end");
-extern const byte sunB_start[] asm("_binary_images_WeatherWidget_dark_sunB_jpg_start");
-extern const byte sunB_end[] asm("_binary_images_WeatherWidget_dark_sunB_jpg_end");
-extern const byte moonB_start[] asm("_binary_images_WeatherWidget_dark_moonB_jpg_start");
-extern const byte moonB_end[] asm("_binary_images_WeatherWidget_dark_moonB_jpg_end");
-extern const byte snowB_start[] asm("_binary_images_WeatherWidget_dark_snowB_jpg_start");
-extern const byte snowB_end[] asm("_binary_images_WeatherWidget_dark_snowB_jpg_end");
-extern const byte rainB_start[] asm("_binary_images_WeatherWidget_dark_rainB_jpg_start");
-extern const byte rainB_end[] asm("_binary_images_WeatherWidget_dark_rainB_jpg_end");
-extern const byte cloudsB_start[] asm("_binary_images_WeatherWidget_dark_cloudsB_jpg_start");
-extern const byte cloudsB_end[] asm("_binary_images_WeatherWidget_dark_cloudsB_jpg_end");
-extern const byte logo_start[] asm("_binary_images_logo_jpg_start");
-extern const byte logo_end[] asm("_binary_images_logo_jpg_end");
+EMBEDDED_ASSET(moonCloudW, "images_packed_WeatherWidget_light_moonCloudW_pimg")
+EMBEDDED_ASSET(sunCloudsW, "images_packed_WeatherWidget_light_sunCloudsW_pimg")
+EMBEDDED_ASSET(sunW, "images_packed_WeatherWidget_light_sunW_pimg")
+EMBEDDED_ASSET(moonW, "images_packed_WeatherWidget_light_moonW_pimg")
+EMBEDDED_ASSET(snowW, "images_packed_WeatherWidget_light_snowW_pimg")
+EMBEDDED_ASSET(rainW, "images_packed_WeatherWidget_light_rainW_pimg")
+EMBEDDED_ASSET(cloudsW, "images_packed_WeatherWidget_light_cloudsW_pimg")
+EMBEDDED_ASSET(moonCloudB, "images_packed_WeatherWidget_dark_moonCloudB_pimg")
+EMBEDDED_ASSET(sunCloudsB, "images_packed_WeatherWidget_dark_sunCloudsB_pimg")
+EMBEDDED_ASSET(sunB, "images_packed_WeatherWidget_dark_sunB_pimg")
+EMBEDDED_ASSET(moonB, "images_packed_WeatherWidget_dark_moonB_pimg")
+EMBEDDED_ASSET(snowB, "images_packed_WeatherWidget_dark_snowB_pimg")
+EMBEDDED_ASSET(rainB, "images_packed_WeatherWidget_dark_rainB_pimg")
+EMBEDDED_ASSET(cloudsB, "images_packed_WeatherWidget_dark_cloudsB_pimg")
+EMBEDDED_ASSET(logo, "images_packed_logo_pimg")
 
 #endif
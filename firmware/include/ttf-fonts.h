@@ -1,6 +1,7 @@
 #ifndef TTF_FONTS_H
 #define TTF_FONTS_H
 
+#include "AssetStore.h"
 #include <Arduino.h>
 
 // All available TTF fonts
@@ -21,23 +22,18 @@ struct TTF_FontMetric {
 const TTF_FontMetric ttfFontMetrics[] = {{ROBOTO_REGULAR, 1.37}, {FINAL_FRONTIER, 1.5}};
 
 // These symbols are generated from the files specified in platformio.ini under 'board_build.embed_files'
+// (subset fonts generated by tools/subset_fonts.py), with ASSET_STORE they are looked up in the assets partition
 // See https://docs.platformio.org/en/latest/platforms/espressif32.html#embedding-binary-data for more info
 
-extern const byte robotoRegular_start[] asm("_binary_fonts_RobotoRegular_ttf_start");
-extern const byte robotoRegular_end[] asm("_binary_fonts_RobotoRegular_ttf_end");
+EMBEDDED_ASSET(robotoRegular, "fonts_subset_RobotoRegular_ttf")
 
-extern const byte finalFrontier_start[] asm("_binary_fonts_FinalFrontier_ttf_start");
-extern const byte finalFrontier_end[] asm("_binary_fonts_FinalFrontier_ttf_end");
+EMBEDDED_ASSET(finalFrontier, "fonts_subset_FinalFrontier_ttf")
 
 // Choose either Classic or Modern here and remember to also adjust platformio.ini
 // *******************************************************************************
-// extern const byte dseg7_start[] asm("_binary_fonts_DSEG7ClassicBold_ttf_start");
-// extern const byte dseg7_end[] asm("_binary_fonts_DSEG7ClassicBold_ttf_end");
-// extern const byte dseg14_start[] asm("_binary_fonts_DSEG14ClassicBold_ttf_start");
-// extern const byte dseg14_end[] asm("_binary_fonts_DSEG14ClassicBold_ttf_end");
-extern const byte dseg7_start[] asm("_binary_fonts_DSEG7ModernBold_ttf_start");
-extern const byte dseg7_end[] asm("_binary_fonts_DSEG7ModernBold_ttf_end");
-extern const byte dseg14_start[] asm("_binary_fonts_DSEG14ModernBold_ttf_start");
-extern const byte dseg14_end[] asm("_binary_fonts_DSEG14ModernBold_ttf_end");
+// EMBEDDED_ASSET(dseg7, "fonts_subset_DSEG7ClassicBold_ttf")
+// EMBEDDED_ASSET(dseg14, "fonts_subset_DSEG14ClassicBold_ttf")
+EMBEDDED_ASSET(dseg7, "fonts_subset_DSEG7ModernBold_ttf")
+EMBEDDED_ASSET(dseg14, "fonts_subset_DSEG14ModernBold_ttf")
 
 #endif
@@ -9,6 +9,7 @@
 // -------------------------------------------------------
 
 #include "OpenFontRender.h"
+#include "cache/ftcmanag.h"
 
 /*_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/*/
 //
@@ -18,11 +19,6 @@
 /*_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/*/
 /*! \cond PRIVATE */
 
-typedef struct {
-	enum OFR::LoadFontFrom from; // data source
-	uint8_t debug_level;         // debug level
-} FontDataInfo;
-
 typedef struct {
 	FT_Glyph glyph;
 	FT_Vector pos;
@@ -108,6 +104,7 @@ OpenFontRender::OpenFontRender() {
 		return;
 	};
 	_drawFastHLine = [](int32_t x, int32_t y, int32_t w, uint16_t c) { return; };
+	_drawHSpan     = [](int32_t x, int32_t y, int32_t w, uint16_t *colors) { return; };
 	_startWrite    = []() { return; };
 	_endWrite      = []() { return; };
 
@@ -115,10 +112,7 @@ OpenFontRender::OpenFontRender() {
 	_cache.max_sizes = OpenFontRender::CACHE_SIZE_MINIMUM;
 	_cache.max_bytes = OpenFontRender::CACHE_SIZE_MINIMUM;
 
-	_face_id.filepath   = nullptr;
-	_face_id.data       = nullptr;
-	_face_id.data_size  = 0;
-	_face_id.face_index = 0;
+	_face_id = nullptr;
 
 	_text.line_space_ratio = 1.0;    // Set default line space ratio
 	_text.size             = 44;     // Set default font size
@@ -127,9 +121,11 @@ OpenFontRender::OpenFontRender() {
 	_text.align            = Align::Left;
 	_text.bg_fill_method   = BgFillMethod::None;
 	_text.layout           = Layout::Horizontal; // Set default layout Horizontal
+	_text.align_to_ink     = false;
 	_debug_level           = OFR_NONE;
 
 	_flags.enable_optimized_drawing = false;
+	_flags.enable_span_drawing      = false;
 
 	_ftc_manager     = nullptr;
 	_ftc_cmap_cache  = nullptr;
@@ -138,6 +134,9 @@ OpenFontRender::OpenFontRender() {
 	_saved_state.drawn_bg_point       = {0, 0};
 	_saved_state.prev_max_font_height = 0;
 	_saved_state.prev_font_size       = 0;
+
+	_blend.valid      = false;
+	_cache_peak_bytes = 0;
 }
 
 /*!
@@ -398,6 +397,27 @@ Align OpenFontRender::getAlignment() {
 	return _text.align;
 }
 
+/*!
+ * @brief Set whether the y position refers to the top of the drawn glyphs instead of the font ascender.
+ * @param[in] (enable) If true, the text is shifted up by the space between ascender and the top of the glyphs.
+ * @ingroup layout_api
+ * @note Default is `false`.
+ * @note The correction is calculated in the same layout pass that draws the text, no extra calculateBoundingBox() call is needed.
+ * @see https://github.com/takkaO/OpenFontRender/issues/38
+ */
+void OpenFontRender::setAlignToInk(bool enable) {
+	_text.align_to_ink = enable;
+}
+
+/*!
+ * @brief Get whether the y position refers to the top of the drawn glyphs.
+ * @return True if enabled.
+ * @ingroup layout_api
+ */
+bool OpenFontRender::getAlignToInk() {
+	return _text.align_to_ink;
+}
+
 /*!
  * @brief Set FreeType cache size.
  * @param[in] (max_faces) Maximum number of opened FT_Face objects.
@@ -413,6 +433,71 @@ void OpenFontRender::setCacheSize(unsigned int max_faces, unsigned int max_sizes
 	_cache.max_bytes = max_bytes;
 }
 
+/*!
+ * @brief Change the maximum number of bytes used for cached glyphs.
+ * @param[in] (max_bytes) Maximum number of bytes to use for cached data.
+ * @ingroup rendering_api
+ * @note Takes effect immediately if a font is loaded (old glyphs are dropped when shrinking), otherwise with the next loadFont().
+ */
+void OpenFontRender::setCacheMaxBytes(unsigned long max_bytes) {
+	_cache.max_bytes = max_bytes;
+	if (!g_NeedInitialize) {
+		_ftc_manager->max_weight = max_bytes;
+		FTC_Manager_Compress(_ftc_manager);
+	}
+}
+
+/*!
+ * @brief Get the maximum number of bytes used for cached glyphs.
+ * @return Byte budget of the glyph cache.
+ * @ingroup rendering_api
+ */
+unsigned long OpenFontRender::getCacheMaxBytes() {
+	return _cache.max_bytes;
+}
+
+/*!
+ * @brief Get the number of bytes currently used by the glyph cache.
+ * @return Used bytes (0 if no font is loaded).
+ * @ingroup rendering_api
+ */
+unsigned long OpenFontRender::getCacheUsedBytes() {
+	return g_NeedInitialize ? 0 : _ftc_manager->cur_weight;
+}
+
+/*!
+ * @brief Get the highest number of bytes used by the glyph cache since the last resetCacheStats().
+ * @return Peak used bytes, i.e. the observed working set (capped by the byte budget).
+ * @ingroup rendering_api
+ */
+unsigned long OpenFontRender::getCachePeakBytes() {
+	return _cache_peak_bytes;
+}
+
+/*!
+ * @brief Get the glyph cache statistics per font size since the last resetCacheStats().
+ * @param[out] (*stats) Array to fill.
+ * @param[in] (max_count) Size of the array.
+ * @return Number of font sizes (may be bigger than max_count).
+ * @ingroup rendering_api
+ * @note The statistics are kept when the font changes.
+ */
+unsigned int OpenFontRender::getCacheStats(GlyphCacheStats *stats, unsigned int max_count) {
+	for (unsigned int i = 0; i < _cache_stats.size() && i < max_count; i++) {
+		stats[i] = _cache_stats[i];
+	}
+	return _cache_stats.size();
+}
+
+/*!
+ * @brief Reset the glyph cache statistics.
+ * @ingroup rendering_api
+ */
+void OpenFontRender::resetCacheStats() {
+	_cache_stats.clear();
+	_cache_peak_bytes = getCacheUsedBytes();
+}
+
 /*!
  * @brief Load font from memory.
  * @param[in] (*data) Font data array.
@@ -420,13 +505,11 @@ void OpenFontRender::setCacheSize(unsigned int max_faces, unsigned int max_sizes
  * @param[in] (target_face_index) Load font index. Default is 0.
  * @return FreeType error code. 0 is success.
  * @ingroup rendering_api
+ * @note Switching to another font keeps the glyphs of all loaded fonts in the glyph cache until unloadFont() is called.
  */
 FT_Error OpenFontRender::loadFont(const unsigned char *data, size_t size, uint8_t target_face_index) {
-	_face_id.data_size = size;
-	_face_id.data      = (unsigned char *)data;
-
-	_face_id.face_index = target_face_index;
-	return loadFont(OFR::FROM_MEMORY);
+	OFR::FaceRec face = {nullptr, (unsigned char *)data, size, target_face_index, OFR::FROM_MEMORY};
+	return loadFont(face);
 }
 
 /*!
@@ -440,32 +523,89 @@ FT_Error OpenFontRender::loadFont(const unsigned char *data, size_t size, uint8_
  * @note Any better solutions are welcome.
  */
 FT_Error OpenFontRender::loadFont(const char *fpath, uint8_t target_face_index) {
-	size_t len = strlen(fpath);
-
-	_face_id.filepath = new char[len + 1]; // Release on unloadFont method
-	strncpy(_face_id.filepath, fpath, len);
-	_face_id.filepath[len] = '\0';
-
-	_face_id.face_index = target_face_index;
-	return loadFont(OFR::FROM_FILE);
+	OFR::FaceRec face = {(char *)fpath, nullptr, 0, target_face_index, OFR::FROM_FILE};
+	return loadFont(face);
 }
 
 /*!
  * @brief Unload font data.
  * @ingroup rendering_api
+ * @note Unloads all fonts and drops the glyph cache.
  */
 void OpenFontRender::unloadFont() {
 	if (!g_NeedInitialize) {
-		FTC_Manager_RemoveFaceID(_ftc_manager, &_face_id);
+		for (OFR::Face face : _faces) {
+			FTC_Manager_RemoveFaceID(_ftc_manager, face);
+		}
 		FTC_Manager_Reset(_ftc_manager);
 		FTC_Manager_Done(_ftc_manager);
 		FT_Done_FreeType(g_FtLibrary);
-
-		delete[] _face_id.filepath;
 	}
+	for (OFR::Face face : _faces) {
+		delete[] face->filepath;
+		delete face;
+	}
+	_faces.clear();
+	_face_id         = nullptr;
 	g_NeedInitialize = true;
 }
 
+/*!
+ * @brief Load the glyphs of a string into the glyph cache without drawing them.
+ * @param[in] (*str) Characters to cache (with the current font and font size).
+ * @return false if the glyphs did not fit into the glyph cache (other glyphs were evicted) or on error.
+ * @ingroup rendering_api
+ * @note Caches both the outlines used for the layout and the rendered bitmaps, so drawing the characters later is served from the cache.
+ */
+bool OpenFontRender::preloadGlyphs(const char *str) {
+	if (g_NeedInitialize) {
+		return false;
+	}
+
+	FT_Int cmap_index;
+	{
+		FT_Size asize = NULL;
+		FTC_ScalerRec scaler;
+		scaler.face_id = _face_id;
+		scaler.width   = 0;
+		scaler.height  = _text.size;
+		scaler.pixel   = true;
+		scaler.x_res   = 0;
+		scaler.y_res   = 0;
+		if (FTC_Manager_LookupSize(_ftc_manager, &scaler, &asize)) {
+			return false;
+		}
+		cmap_index = FT_Get_Charmap_Index(asize->face->charmap);
+	}
+
+	FTC_ImageTypeRec image_type;
+	image_type.face_id = _face_id;
+	image_type.width   = 0;
+	image_type.height  = _text.size;
+
+	// Outlines for the layout pass, bitmaps for the drawing pass
+	const FT_Int32 load_flags[] = {FT_LOAD_DEFAULT, FT_LOAD_RENDER};
+	unsigned long evicted       = _ftc_manager->num_evicted;
+	uint16_t len                = (uint16_t)strlen(str);
+	uint16_t n                  = 0;
+	while (n < len) {
+		uint16_t unicode    = decodeUTF8((uint8_t *)str, &n, len - n);
+		FT_UInt glyph_index = FTC_CMapCache_Lookup(_ftc_cmap_cache, _face_id, cmap_index, unicode);
+		FT_Glyph aglyph;
+		for (FT_Int32 flags : load_flags) {
+			image_type.flags     = flags;
+			CacheCounters before = getCacheCounters();
+			FT_Error error       = FTC_ImageCache_Lookup(_ftc_image_cache, &image_type, glyph_index, &aglyph, NULL);
+			countCacheLookup(image_type.height, before);
+			if (error) {
+				debugPrintf((_debug_level & OFR_ERROR), "FTC_ImageCache_Lookup error: 0x%02X\n", error);
+				return false;
+			}
+		}
+	}
+	return _ftc_manager->num_evicted == evicted;
+}
+
 /*!
  * @brief Renders text horizontally.
  * @param[in] (*str) String to draw.
@@ -497,12 +637,13 @@ uint16_t OpenFontRender::drawHString(const char *str,
 	Cursor current_line_position = {x, y};
 	FT_Pos ascender              = 0;
 	bool detect_control_char     = false;
+	bool is_first_line           = true;
 
 	abbox.xMin = abbox.yMin = LONG_MAX;
 	abbox.xMax = abbox.yMax = LONG_MIN;
 
 	FTC_ImageTypeRec image_type;
-	image_type.face_id = &_face_id;
+	image_type.face_id = _face_id;
 	image_type.width   = 0;
 	image_type.height  = _text.size;
 	image_type.flags   = FT_LOAD_DEFAULT;
@@ -523,7 +664,7 @@ uint16_t OpenFontRender::drawHString(const char *str,
 	{
 		FT_Size asize = NULL;
 		FTC_ScalerRec scaler;
-		scaler.face_id = &_face_id;
+		scaler.face_id = _face_id;
 		scaler.width   = 0;
 		scaler.height  = _text.size;
 		scaler.pixel   = true;
@@ -567,11 +708,13 @@ uint16_t OpenFontRender::drawHString(const char *str,
 				break;
 			default:
 				glyph_index = FTC_CMapCache_Lookup(_ftc_cmap_cache,
-				                                   &_face_id,
+				                                   _face_id,
 				                                   cmap_index,
 				                                   unicode);
 
-				error = FTC_ImageCache_Lookup(_ftc_image_cache, &image_type, glyph_index, &aglyph, NULL);
+				CacheCounters before = getCacheCounters();
+				error                = FTC_ImageCache_Lookup(_ftc_image_cache, &image_type, glyph_index, &aglyph, NULL);
+				countCacheLookup(image_type.height, before);
 				if (error) {
 					debugPrintf((_debug_level & OFR_ERROR), "FTC_ImageCache_Lookup error: 0x%02X\n", error);
 					return written_char_num;
@@ -579,10 +722,9 @@ uint16_t OpenFontRender::drawHString(const char *str,
 
 				FT_Glyph_Get_CBox(aglyph, FT_GLYPH_BBOX_PIXELS, &glyph_bbox);
 				if (isLineFirstChar == true) {
-					// Get bearing X
-					FT_Face aface;
-					FTC_Manager_LookupFace(_ftc_manager, &_face_id, &aface);
-					bearing_left.x = (aface->glyph->metrics.horiBearingX >> 6);
+					// Get bearing X from the (cached) glyph, the glyph slot of the face
+					// only holds the metrics of the last glyph that was actually loaded
+					bearing_left.x = glyph_bbox.xMin;
 					// nothing to do for bearing.y
 					isLineFirstChar = false;
 				}
@@ -620,7 +762,17 @@ uint16_t OpenFontRender::drawHString(const char *str,
 			}
 			// Correct slight misalignment of X-axis
 			offset.x = bbox.xMin - current_line_position.x;
+
+			if (_text.align_to_ink && is_first_line) {
+				// Move everything up, so the top of the first line's glyphs is at y
+				// (the following lines are placed relative to it)
+				int32_t ink_offset = bbox.yMin - current_line_position.y;
+				bbox.yMin -= ink_offset;
+				bbox.yMax -= ink_offset;
+				current_line_position.y -= ink_offset;
+			}
 		}
+		is_first_line = false;
 		// Serial.printf("bbox2: x=%f %f, y=%f %f\n", bbox.xMin, bbox.xMax, bbox.yMin, bbox.yMax);
 
 		// Calculate alignment offset
@@ -721,10 +873,11 @@ uint16_t OpenFontRender::drawHString(const char *str,
 				rendering_unicode = rendering_unicode_q.front();
 
 				FT_UInt glyph_index = FTC_CMapCache_Lookup(_ftc_cmap_cache,
-				                                           &_face_id,
+				                                           _face_id,
 				                                           cmap_index,
 				                                           rendering_unicode);
 				FT_Glyph aglyph;
+				CacheCounters before = getCacheCounters();
 #ifdef FREERTOS_CONFIG_H
 				if (g_UseRenderTask) {
 					if (g_RenderTaskHandle == NULL) {
@@ -762,6 +915,7 @@ uint16_t OpenFontRender::drawHString(const char *str,
 #else
 				error = FTC_ImageCache_Lookup(_ftc_image_cache, &image_type, glyph_index, &aglyph, NULL);
 #endif
+				countCacheLookup(image_type.height, before);
 				if (error) {
 					debugPrintf((_debug_level & OFR_ERROR), "FTC_ImageCache_Lookup error: 0x%02X\n", error);
 					return written_char_num;
@@ -1112,6 +1266,58 @@ uint32_t OpenFontRender::getTextHeight(const char *fmt, ...) {
 	return (bbox.yMax - bbox.yMin);
 }
 
+/*!
+ * @brief Calculate the sum of the glyph advances of a single line of text.
+ * @param[in] (*str) Target string.
+ * @param[in] (font_size) Font size.
+ * @return Distance the cursor moves when drawing the string.
+ * @ingroup rendering_api
+ * @note Unlike getTextWidth(), this includes the side bearings and whitespace, so the advances of words can be added up for text layout.
+ * @note Only glyph metrics are looked up, nothing is rendered.
+ */
+uint32_t OpenFontRender::getTextAdvance(const char *str, unsigned int font_size) {
+	FTC_ImageTypeRec image_type;
+	image_type.face_id = _face_id;
+	image_type.width   = 0;
+	image_type.height  = font_size;
+	image_type.flags   = FT_LOAD_DEFAULT;
+
+	FT_Int cmap_index;
+	{
+		FT_Size asize = NULL;
+		FTC_ScalerRec scaler;
+		scaler.face_id = _face_id;
+		scaler.width   = 0;
+		scaler.height  = font_size;
+		scaler.pixel   = true;
+		scaler.x_res   = 0;
+		scaler.y_res   = 0;
+
+		if (FTC_Manager_LookupSize(_ftc_manager, &scaler, &asize)) {
+			return 0;
+		}
+		cmap_index = FT_Get_Charmap_Index(asize->face->charmap);
+	}
+
+	uint32_t advance = 0;
+	uint16_t len     = (uint16_t)strlen(str);
+	uint16_t n       = 0;
+	while (n < len) {
+		uint16_t unicode = decodeUTF8((uint8_t *)str, &n, len - n);
+		FT_UInt glyph_index = FTC_CMapCache_Lookup(_ftc_cmap_cache, _face_id, cmap_index, unicode);
+		FT_Glyph aglyph;
+		CacheCounters before = getCacheCounters();
+		FT_Error error       = FTC_ImageCache_Lookup(_ftc_image_cache, &image_type, glyph_index, &aglyph, NULL);
+		countCacheLookup(image_type.height, before);
+		if (error) {
+			debugPrintf((_debug_level & OFR_ERROR), "FTC_ImageCache_Lookup error\n");
+			break;
+		}
+		advance += (aglyph->advance.x >> 16);
+	}
+	return advance;
+}
+
 /*!
  * @brief Calculates the maximum font size that will fit the specified format string and the specified rectangle.
  * @param[in] (limit_width) Limit width size.
@@ -1156,53 +1362,41 @@ unsigned int OpenFontRender::calculateFitFontSize(uint32_t limit_width,
                                                   Layout layout,
                                                   const char *str) {
 	FT_Error error;
-	FT_BBox bbox1              = {0, 0, 0, 0};
-	FT_BBox bbox2              = {0, 0, 0, 0};
+	FT_BBox bbox               = {0, 0, 0, 0};
 	unsigned int tmp_font_size = getFontSize();
 	Cursor tmp_cursor          = _text.cursor;
-	unsigned int fs1           = 10;
-	unsigned int fs2           = 50;
-	int32_t w1, w2, h1, h2;
+	bool tmp_align_to_ink      = _text.align_to_ink;
+	// Glyph size scales (nearly) linearly with the font size, so a single layout pass at a reference size is enough
+	const unsigned int fs = 50;
+	int32_t w, h;
 
-	// point1
-	setFontSize(fs1);
+	setFontSize(fs);
+	_text.align_to_ink = false;
 	switch (layout) {
 	case Layout::Horizontal:
-		drawHString(str, 0, 0, 0xFFFF, 0x0000, Align::Left, Drawing::Skip, bbox1, error);
+		drawHString(str, 0, 0, 0xFFFF, 0x0000, Align::Left, Drawing::Skip, bbox, error);
 		break;
 	case Layout::Vertical:
 		// Not support now
 		break;
 	default:
 		setFontSize(tmp_font_size);
-		_text.cursor = tmp_cursor;
+		_text.cursor       = tmp_cursor;
+		_text.align_to_ink = tmp_align_to_ink;
 		return 0;
 	}
-	w1 = bbox1.xMax - bbox1.xMin;
-	h1 = bbox1.yMax - bbox1.yMin;
+	w = bbox.xMax - bbox.xMin;
+	h = bbox.yMax - bbox.yMin;
 
-	// point2
-	setFontSize(fs2);
-	switch (layout) {
-	case Layout::Horizontal:
-		drawHString(str, 0, 0, 0xFFFF, 0x0000, Align::Left, Drawing::Skip, bbox2, error);
-		break;
-	case Layout::Vertical:
-		// Not support now
-		break;
-	default:
-		setFontSize(tmp_font_size);
-		_text.cursor = tmp_cursor;
+	setFontSize(tmp_font_size);
+	_text.cursor       = tmp_cursor;
+	_text.align_to_ink = tmp_align_to_ink;
+
+	if (w <= 0 || h <= 0) {
 		return 0;
 	}
-	w2 = bbox2.xMax - bbox2.xMin;
-	h2 = bbox2.yMax - bbox2.yMin;
-
-	unsigned int wfs = (unsigned int)(((fs2 - fs1) / (w2 - w1 + 0.000001)) * (limit_width - w1) + fs1);
-	unsigned int hfs = (unsigned int)(((fs2 - fs1) / (h2 - h1 + 0.000001)) * (limit_height - h1) + fs1);
-
-	setFontSize(tmp_font_size);
-	_text.cursor = tmp_cursor;
+	unsigned int wfs = (unsigned int)((uint64_t)fs * limit_width / w);
+	unsigned int hfs = (unsigned int)((uint64_t)fs * limit_height / h);
 
 	return std::min(wfs, hfs);
 }
@@ -1284,6 +1478,10 @@ void OpenFontRender::set_drawFastHLine(std::function<void(int32_t, int32_t, int3
 	_drawFastHLine                  = user_func;
 	_flags.enable_optimized_drawing = true; // Enable optimized drawing method
 }
+void OpenFontRender::set_drawHSpan(std::function<void(int32_t, int32_t, int32_t, uint16_t *)> user_func) {
+	_drawHSpan                 = user_func;
+	_flags.enable_span_drawing = true; // Enable span drawing method
+}
 void OpenFontRender::set_startWrite(std::function<void(void)> user_func) {
 	_startWrite = user_func;
 }
@@ -1303,10 +1501,32 @@ void OpenFontRender::set_printFunc(std::function<void(const char *)> user_func)
 //
 /*_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/*/
 
-FT_Error OpenFontRender::loadFont(enum OFR::LoadFontFrom from) {
+FT_Error OpenFontRender::loadFont(const OFR::FaceRec &face_rec) {
 	FT_Face face;
 	FT_Error error;
-	FontDataInfo info = {from, _debug_level};
+
+	// Fonts stay in the glyph cache when switching between them, reuse the face ID
+	// (the cache key) if the font was loaded before
+	_face_id = nullptr;
+	for (OFR::Face known : _faces) {
+		if (known->from == face_rec.from && known->face_index == face_rec.face_index
+		    && (face_rec.from == OFR::FROM_MEMORY ? known->data == face_rec.data : strcmp(known->filepath, face_rec.filepath) == 0)) {
+			_face_id = known;
+			break;
+		}
+	}
+	if (_face_id == nullptr) {
+		_face_id = new OFR::FaceRec(face_rec);
+		if (face_rec.filepath != nullptr) {
+			size_t len         = strlen(face_rec.filepath);
+			_face_id->filepath = new char[len + 1]; // Release on unloadFont method
+			strncpy(_face_id->filepath, face_rec.filepath, len);
+			_face_id->filepath[len] = '\0';
+		}
+		_faces.push_back(_face_id);
+	}
+	// Max height depends on the font
+	_saved_state.prev_font_size = 0;
 
 	if (g_NeedInitialize) {
 		error = FT_Init_FreeType(&g_FtLibrary);
@@ -1315,30 +1535,31 @@ FT_Error OpenFontRender::loadFont(enum OFR::LoadFontFrom from) {
 			return error;
 		}
 		g_NeedInitialize = false;
-	}
 
-	// 現在の引数は適当
-	error = FTC_Manager_New(g_FtLibrary, _cache.max_faces, _cache.max_sizes, _cache.max_bytes, &ftc_face_requester, &info, &_ftc_manager);
-	if (error) {
-		debugPrintf((_debug_level & OFR_ERROR), "FTC_Manager_New error: 0x%02X\n", error);
-		return error;
-	}
+		// 現在の引数は適当
+		// The face requester may be called again later (after a face was flushed), so pass a member as request data
+		error = FTC_Manager_New(g_FtLibrary, _cache.max_faces, _cache.max_sizes, _cache.max_bytes, &ftc_face_requester, &_debug_level, &_ftc_manager);
+		if (error) {
+			debugPrintf((_debug_level & OFR_ERROR), "FTC_Manager_New error: 0x%02X\n", error);
+			return error;
+		}
 
-	error = FTC_Manager_LookupFace(_ftc_manager, &_face_id, &face);
-	if (error) {
-		debugPrintf((_debug_level & OFR_ERROR), "FTC_Manager_LookupFace error: 0x%02X\n", error);
-		return error;
-	}
+		error = FTC_CMapCache_New(_ftc_manager, &_ftc_cmap_cache);
+		if (error) {
+			debugPrintf((_debug_level & OFR_ERROR), "FTC_CMapCache_New error: 0x%02X\n", error);
+			return error;
+		}
 
-	error = FTC_CMapCache_New(_ftc_manager, &_ftc_cmap_cache);
-	if (error) {
-		debugPrintf((_debug_level & OFR_ERROR), "FTC_CMapCache_New error: 0x%02X\n", error);
-		return error;
+		error = FTC_ImageCache_New(_ftc_manager, &_ftc_image_cache);
+		if (error) {
+			debugPrintf((_debug_level & OFR_ERROR), "FTC_ImageCache_New error: 0x%02X\n", error);
+			return error;
+		}
 	}
 
-	error = FTC_ImageCache_New(_ftc_manager, &_ftc_image_cache);
+	error = FTC_Manager_LookupFace(_ftc_manager, _face_id, &face);
 	if (error) {
-		debugPrintf((_debug_level & OFR_ERROR), "FTC_ImageCache_New error: 0x%02X\n", error);
+		debugPrintf((_debug_level & OFR_ERROR), "FTC_Manager_LookupFace error: 0x%02X\n", error);
 		return error;
 	}
 
@@ -1362,7 +1583,7 @@ uint32_t OpenFontRender::getFontMaxHeight() {
 		return _saved_state.prev_max_font_height;
 	}
 
-	scaler.face_id = &_face_id;
+	scaler.face_id = _face_id;
 	scaler.width   = 0;
 	scaler.height  = _text.size;
 	scaler.pixel   = true;
@@ -1385,9 +1606,50 @@ uint32_t OpenFontRender::getFontMaxHeight() {
 }
 
 void OpenFontRender::draw2screen(FT_BitmapGlyph glyph, uint32_t x, uint32_t y, uint16_t fg, uint16_t bg) {
+	if (!_blend.valid || _blend.fg != fg || _blend.bg != bg) {
+		updateBlendTable(fg, bg);
+	}
+	const uint16_t *blend = _blend.colors;
+
 	_startWrite();
 
-	if (_flags.enable_optimized_drawing) {
+	if (_flags.enable_span_drawing) {
+		// Blend each glyph row into a line buffer and push every run of visible pixels with a single call.
+		// Transparent pixels are skipped (not painted with bg), so overlapping glyphs stay intact.
+		if (_span_buffer.size() < glyph->bitmap.width) {
+			_span_buffer.resize(glyph->bitmap.width);
+		}
+		uint16_t *line = _span_buffer.data();
+
+		for (int32_t _y = 0; _y < glyph->bitmap.rows; ++_y) {
+			const uint8_t *row = glyph->bitmap.buffer + _y * glyph->bitmap.pitch;
+			int32_t run_start  = -1;
+
+			for (int32_t _x = 0; _x <= (int32_t)glyph->bitmap.width; ++_x) {
+				bool visible = false;
+				if (_x < (int32_t)glyph->bitmap.width) {
+					uint8_t alpha = row[_x];
+					if (alpha == 0xFF) {
+						line[_x] = fg;
+						visible  = true;
+					} else if (alpha) {
+						line[_x] = blend[alpha >> OFR_BLEND_SHIFT];
+						visible  = true;
+					} else if (_text.bg_fill_method == BgFillMethod::Minimum && _saved_state.drawn_bg_point.x <= (x + _x)) {
+						line[_x] = bg;
+						visible  = true;
+					}
+				}
+
+				if (visible && run_start < 0) {
+					run_start = _x;
+				} else if (!visible && run_start >= 0) {
+					_drawHSpan(x + glyph->left + run_start, _y + y - glyph->top, _x - run_start, line + run_start);
+					run_start = -1;
+				}
+			}
+		}
+	} else if (_flags.enable_optimized_drawing) {
 		// Start of new render code for efficient rendering of pixel runs to a TFT
 		// Background fill code commented out thus //-bg-// as it is only filling the glyph bounding box
 		// Code for this will need to track the last background end x as glyphs may overlap
@@ -1419,7 +1681,7 @@ void OpenFontRender::draw2screen(FT_BitmapGlyph glyph, uint32_t x, uint32_t y, u
 							}
 							fl = 0;
 						}
-						_drawPixel(_x + x + glyph->left, _y + y - glyph->top, alphaBlend(alpha, fg, bg));
+						_drawPixel(_x + x + glyph->left, _y + y - glyph->top, blend[alpha >> OFR_BLEND_SHIFT]);
 					} else {
 						if (fl == 0) {
 							fxs = _x + x + glyph->left;
@@ -1461,7 +1723,7 @@ void OpenFontRender::draw2screen(FT_BitmapGlyph glyph, uint32_t x, uint32_t y, u
 				debugPrintf((_debug_level & OFR_DEBUG) ? OFR_RAW : OFR_NONE, "%c", (alpha == 0x00 ? ' ' : 'o'));
 
 				if (alpha) {
-					_drawPixel(_x + x + glyph->left, _y + y - glyph->top, alphaBlend(alpha, fg, bg));
+					_drawPixel(_x + x + glyph->left, _y + y - glyph->top, blend[alpha >> OFR_BLEND_SHIFT]);
 				} else if (_text.bg_fill_method == BgFillMethod::Minimum) {
 					if (_saved_state.drawn_bg_point.x <= (x + _x)) {
 						_drawPixel(_x + x + glyph->left, _y + y - glyph->top, bg);
@@ -1475,6 +1737,28 @@ void OpenFontRender::draw2screen(FT_BitmapGlyph glyph, uint32_t x, uint32_t y, u
 	_endWrite();
 }
 
+OpenFontRender::CacheCounters OpenFontRender::getCacheCounters() {
+	return {_ftc_manager->num_new_nodes, _ftc_manager->num_evicted};
+}
+
+void OpenFontRender::countCacheLookup(unsigned int font_size, const CacheCounters &before) {
+	GlyphCacheStats *stats = nullptr;
+	for (GlyphCacheStats &s : _cache_stats) {
+		if (s.font_size == font_size) {
+			stats = &s;
+			break;
+		}
+	}
+	if (stats == nullptr) {
+		_cache_stats.push_back({font_size, 0, 0, 0});
+		stats = &_cache_stats.back();
+	}
+	stats->lookups++;
+	stats->misses += _ftc_manager->num_new_nodes - before.new_nodes;
+	stats->evictions += _ftc_manager->num_evicted - before.evicted;
+	_cache_peak_bytes = std::max(_cache_peak_bytes, (unsigned long)_ftc_manager->cur_weight);
+}
+
 uint16_t OpenFontRender::decodeUTF8(uint8_t *buf, uint16_t *index, uint16_t remaining) {
 	uint16_t c = buf[(*index)++];
 	//
@@ -1523,6 +1807,17 @@ uint16_t OpenFontRender::alphaBlend(uint8_t alpha, uint16_t fgc, uint16_t bgc) {
 	return (r << 11) | (g << 5) | (b << 0);
 }
 
+void OpenFontRender::updateBlendTable(uint16_t fg, uint16_t bg) {
+	// Spread the levels over the full alpha range so the first is bg and the last is fg
+	for (uint16_t level = 0; level < OFR_BLEND_LEVELS; level++) {
+		uint8_t alpha        = (level * 255) / (OFR_BLEND_LEVELS - 1);
+		_blend.colors[level] = alphaBlend(alpha, fg, bg);
+	}
+	_blend.fg    = fg;
+	_blend.bg    = bg;
+	_blend.valid = true;
+}
+
 /*_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/*/
 //
 //  Functions
@@ -1532,32 +1827,32 @@ uint16_t OpenFontRender::alphaBlend(uint8_t alpha, uint16_t fgc, uint16_t bgc) {
 /*! \cond PRIVATE */
 
 FT_Error ftc_face_requester(FTC_FaceID face_id, FT_Library library, FT_Pointer request_data, FT_Face *aface) {
-	FT_Error error     = FT_Err_Ok;
-	OFR::Face face     = (OFR::Face)face_id;
-	FontDataInfo *info = (FontDataInfo *)request_data;
+	FT_Error error      = FT_Err_Ok;
+	OFR::Face face      = (OFR::Face)face_id;
+	uint8_t debug_level = *(uint8_t *)request_data;
 
-	debugPrintf((info->debug_level & OFR_INFO), "Font load required. FaceId: 0x%p\n", face_id);
+	debugPrintf((debug_level & OFR_INFO), "Font load required. FaceId: 0x%p\n", face_id);
 
-	if (info->from == OFR::FROM_FILE) {
-		debugPrintf((info->debug_level & OFR_INFO), "Load from file.\n");
+	if (face->from == OFR::FROM_FILE) {
+		debugPrintf((debug_level & OFR_INFO), "Load from file.\n");
 		const uint8_t FACE_INDEX = 0;
 
 		error = FT_New_Face(library, face->filepath, FACE_INDEX, aface); // create face object
 		if (error) {
-			debugPrintf((info->debug_level & OFR_ERROR), "Font load Failed: 0x%02X\n", error);
+			debugPrintf((debug_level & OFR_ERROR), "Font load Failed: 0x%02X\n", error);
 		} else {
-			debugPrintf((info->debug_level & OFR_INFO), "Font load Success!\n");
+			debugPrintf((debug_level & OFR_INFO), "Font load Success!\n");
 		}
 
-	} else if (info->from == OFR::FROM_MEMORY) {
-		debugPrintf((info->debug_level & OFR_INFO), "Load from memory.\n");
+	} else if (face->from == OFR::FROM_MEMORY) {
+		debugPrintf((debug_level & OFR_INFO), "Load from memory.\n");
 		const uint8_t FACE_INDEX = 0;
 
 		error = FT_New_Memory_Face(library, face->data, face->data_size, FACE_INDEX, aface); // create face object
 		if (error) {
-			debugPrintf((info->debug_level & OFR_ERROR), "Font load Failed: 0x%02X\n", error);
+			debugPrintf((debug_level & OFR_ERROR), "Font load Failed: 0x%02X\n", error);
 		} else {
-			debugPrintf((info->debug_level & OFR_INFO), "Font load Success!\n");
+			debugPrintf((debug_level & OFR_INFO), "Font load Success!\n");
 		}
 	}
 	return error;
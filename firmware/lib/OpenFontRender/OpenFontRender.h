@@ -38,6 +38,12 @@
 //
 /*_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/_/*/
 
+/*!
+ * @brief Number of anti-aliasing levels in the precomputed fg/bg blend table (32 levels = 5 bit alpha).
+ */
+#define OFR_BLEND_LEVELS 32
+#define OFR_BLEND_SHIFT  3 ///< Shift from 8 bit alpha to a blend table index.
+
 /*!
  * @brief An enumeration for specifying the debug log level.
  */
@@ -93,6 +99,17 @@ enum class Drawing {
 	Skip     ///< The drawing process is skiped and the screen will not be updated.
 };
 
+/*!
+ * @brief Glyph cache statistics for one font size.
+ * @see getCacheStats
+ */
+struct GlyphCacheStats {
+	unsigned int font_size; ///< Font size in pixels.
+	uint32_t lookups;       ///< Number of glyph image lookups.
+	uint32_t misses;        ///< Lookups that had to load (and render) the glyph.
+	uint32_t evictions;     ///< Cached glyphs dropped to stay within the byte budget.
+};
+
 /*! \cond PRIVATE */
 namespace OFR {
 	/* USER DO NOT USE DIRECTORY IN THIS SCOPE ELEMENTS */
@@ -106,6 +123,7 @@ namespace OFR {
 		unsigned char *data; // ttf array
 		size_t data_size;    // ttf array size
 		uint8_t face_index;  // face index (default is 0)
+		LoadFontFrom from;   // data source
 	} FaceRec, *Face;
 };
 /*! \endcond */
@@ -147,6 +165,18 @@ namespace OFR {
  * | int32_t |  c   | Draw color (16 bit color) |
  */
 #define setDrawFastHLine(F) set_drawFastHLine([&](int32_t x, int32_t y, int32_t w, uint16_t c) { return F(x, y, w, c); })
+/*!
+ * @brief Set function to draw a horizontal run of pixels with individual colors to screen. (Optional)
+ * @param[in] (user_func) User function for drawing a pixel run to screen.
+ * @ingroup rendering_api
+ * @note If you set this function, each glyph row is blended into a line buffer and pushed as one run per visible span,
+ * @note which is much faster than drawing anti-aliased pixels one by one.
+ * @note The colors are 16 bit rgb565 in native byte order, the function may modify the buffer.
+ * @code {.cpp}
+ * void example_function (int32_t x, int32_t y, int32_t w, uint16_t *colors)
+ * @endcode
+ */
+#define setDrawHSpan(F) set_drawHSpan([&](int32_t x, int32_t y, int32_t w, uint16_t *colors) { return F(x, y, w, colors); })
 /*!
  * @brief It is called only once at the beginning of a sequence of drawings. (Optional)
  * @brief Certain libraries can occupy the bus during continuous drawing to increase the drawing speed.
@@ -223,11 +253,20 @@ public:
 	Layout getLayout();
 	void setAlignment(Align align);
 	Align getAlignment();
+	void setAlignToInk(bool enable);
+	bool getAlignToInk();
 	void setCacheSize(unsigned int max_faces, unsigned int max_sizes, unsigned long max_bytes);
+	void setCacheMaxBytes(unsigned long max_bytes);
+	unsigned long getCacheMaxBytes();
+	unsigned long getCacheUsedBytes();
+	unsigned long getCachePeakBytes();
+	unsigned int getCacheStats(GlyphCacheStats *stats, unsigned int max_count);
+	void resetCacheStats();
 
 	FT_Error loadFont(const unsigned char *data, size_t size, uint8_t target_face_index = 0);
 	FT_Error loadFont(const char *fpath, uint8_t target_face_index = 0);
 	void unloadFont();
+	bool preloadGlyphs(const char *str);
 
 	uint16_t drawHString(const char *str,
 	                     int32_t x,
@@ -272,6 +311,7 @@ public:
 
 	uint32_t getTextWidth(const char *fmt, ...);
 	uint32_t getTextHeight(const char *fmt, ...);
+	uint32_t getTextAdvance(const char *str, unsigned int font_size);
 
 	unsigned int calculateFitFontSizeFmt(uint32_t limit_width, uint32_t limit_height, Layout layout, const char *fmt, ...);
 	unsigned int calculateFitFontSize(uint32_t limit_width, uint32_t limit_height, Layout layout, const char *str);
@@ -303,6 +343,7 @@ public:
 	// Direct calls are deprecated.
 	void set_drawPixel(std::function<void(int32_t, int32_t, uint16_t)> user_func);
 	void set_drawFastHLine(std::function<void(int32_t, int32_t, int32_t, uint16_t)> user_func);
+	void set_drawHSpan(std::function<void(int32_t, int32_t, int32_t, uint16_t *)> user_func);
 	void set_startWrite(std::function<void(void)> user_func);
 	void set_endWrite(std::function<void(void)> user_func);
 
@@ -331,15 +372,25 @@ public:
 	};
 
 private:
-	FT_Error loadFont(enum OFR::LoadFontFrom from);
+	FT_Error loadFont(const OFR::FaceRec &face);
 	uint32_t getFontMaxHeight();
 	void draw2screen(FT_BitmapGlyph glyph, uint32_t x, uint32_t y, uint16_t fg, uint16_t bg);
 	uint16_t decodeUTF8(uint8_t *buf, uint16_t *index, uint16_t remaining);
 	uint16_t color565(uint8_t r, uint8_t g, uint8_t b);
 	uint16_t alphaBlend(uint8_t alpha, uint16_t fgc, uint16_t bgc);
+	void updateBlendTable(uint16_t fg, uint16_t bg);
+
+	struct CacheCounters {
+		unsigned long new_nodes;
+		unsigned long evicted;
+	};
+	CacheCounters getCacheCounters();
+	void countCacheLookup(unsigned int font_size, const CacheCounters &before);
 
 	std::function<void(int32_t, int32_t, uint16_t)> _drawPixel;
 	std::function<void(int32_t, int32_t, int32_t, uint16_t)> _drawFastHLine;
+	std::function<void(int32_t, int32_t, int32_t, uint16_t *)> _drawHSpan;
+	std::vector<uint16_t> _span_buffer; // Line buffer for one glyph row
 	std::function<void(void)> _startWrite;
 	std::function<void(void)> _endWrite;
 
@@ -347,10 +398,12 @@ private:
 	FTC_CMapCache _ftc_cmap_cache;
 	FTC_ImageCache _ftc_image_cache;
 
-	OFR::FaceRec _face_id;
+	OFR::Face _face_id;              // Current font
+	std::vector<OFR::Face> _faces; // All fonts loaded since unloadFont(), they share the glyph cache
 
 	struct Flags {
 		bool enable_optimized_drawing;
+		bool enable_span_drawing;
 		bool support_vertical;
 	};
 	struct Flags _flags;
@@ -361,6 +414,8 @@ private:
 		unsigned long max_bytes;
 	};
 	struct CacheParameter _cache;
+	std::vector<GlyphCacheStats> _cache_stats; // One entry per font size
+	unsigned long _cache_peak_bytes;
 
 	struct SavedStateVariables {
 		struct Cursor drawn_bg_point;
@@ -369,6 +424,15 @@ private:
 	};
 	struct SavedStateVariables _saved_state;
 
+	// Precomputed alpha ramp between fg and bg, indexed by (alpha >> OFR_BLEND_SHIFT)
+	struct BlendTable {
+		bool valid;
+		uint16_t fg;
+		uint16_t bg;
+		uint16_t colors[OFR_BLEND_LEVELS];
+	};
+	struct BlendTable _blend;
+
 	struct TextParameter {
 		double line_space_ratio;
 		unsigned int size;
@@ -378,6 +442,7 @@ private:
 		Align align;
 		BgFillMethod bg_fill_method;
 		Layout layout;
+		bool align_to_ink;
 	};
 	struct TextParameter _text;
 
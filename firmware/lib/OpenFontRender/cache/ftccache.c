@@ -433,6 +433,7 @@
 
 
       manager->cur_weight += cache->clazz.node_weight( node, cache );
+      manager->num_new_nodes++;
 
       if ( manager->cur_weight >= manager->max_weight )
       {
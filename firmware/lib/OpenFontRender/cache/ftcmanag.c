@@ -560,7 +560,10 @@
       prev = ( node == first ) ? NULL : FTC_NODE__PREV( node );
 
       if ( node->ref_count <= 0 )
+      {
         ftc_node_destroy( node, manager );
+        manager->num_evicted++;
+      }
 
       node = prev;
 
@@ -646,6 +649,7 @@
       if ( node->ref_count <= 0 )
       {
         ftc_node_destroy( node, manager );
+        manager->num_evicted++;
         result++;
       }
 
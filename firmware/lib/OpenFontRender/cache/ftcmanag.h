@@ -107,6 +107,10 @@ FT_BEGIN_HEADER
     FT_Pointer          request_data;
     FTC_Face_Requester  request_face;
 
+    /* statistics for OpenFontRender (not part of upstream FreeType) */
+    FT_ULong            num_new_nodes;  /* nodes added on cache misses   */
+    FT_ULong            num_evicted;    /* nodes dropped to fit max_weight */
+
   } FTC_ManagerRec;
 
 
@@ -0,0 +1,141 @@
+#include "ApiQuota.h"
+
+#include "EndpointHealth.h"
+#include "InflateStream.h"
+
+ApiQuota *ApiQuota::m_instance = nullptr;
+
+ApiQuota *ApiQuota::getInstance() {
+    if (m_instance == nullptr) {
+        m_instance = new ApiQuota();
+    }
+    return m_instance;
+}
+
+int ApiQuota::fetch(const String &host, uint16_t cost, const String &url, HTTPClient &http, InflateStream &body) {
+    if (!EndpointHealth::getInstance()->allow(host) || !getInstance()->acquire(host, cost)) {
+        return QUOTA_NOT_SENT;
+    }
+    collectHeaders(http);
+    http.begin(url);
+    body.prepare(http);
+    int httpCode = http.GET();
+    getInstance()->handleResponse(host, http, httpCode);
+    // Error answers (e.g. an invalid key or an unknown symbol) still mean the server is up
+    if (httpCode > 0 && httpCode < 500) {
+        EndpointHealth::getInstance()->success(host);
+    } else {
+        EndpointHealth::getInstance()->failure(host);
+    }
+    return httpCode;
+}
+
+ApiQuota::ApiQuota() {
+    define(QUOTA_HOST_TWELVEDATA, QUOTA_TWELVEDATA_DAILY, QUOTA_TWELVEDATA_BURST);
+    define(QUOTA_HOST_VISUALCROSSING, QUOTA_VISUALCROSSING_DAILY, QUOTA_VISUALCROSSING_BURST);
+    // Free plan: one request per second, no daily limit
+    define(QUOTA_HOST_TIMEZONEDB, 86400, 1);
+}
+
+void ApiQuota::define(const String &host, float daily, float burst) {
+    Bucket &bucket = m_buckets[host];
+    bucket.capacity = burst;
+    bucket.tokens = burst;
+    bucket.perMs = daily / 86400000.0f;
+    bucket.lastRefill = millis();
+}
+
+void ApiQuota::collectHeaders(HTTPClient &http) {
+    // twelvedata sends api-credits-left, others the common X-RateLimit headers
+    static const char *keys[] = {"Retry-After", "X-RateLimit-Remaining", "X-RateLimit-Reset", "api-credits-left"};
+    http.collectHeaders(keys, 4);
+}
+
+ApiQuota::Bucket *ApiQuota::find(const String &host) {
+    auto it = m_buckets.find(host);
+    return it == m_buckets.end() ? nullptr : &it->second;
+}
+
+void ApiQuota::refill(Bucket &bucket) {
+    unsigned long now = millis();
+    bucket.tokens = min(bucket.capacity, bucket.tokens + (now - bucket.lastRefill) * bucket.perMs);
+    bucket.lastRefill = now;
+}
+
+long ApiQuota::getMillisToAvailable(const String &host, uint16_t cost) {
+    Bucket *bucket = find(host);
+    if (bucket == nullptr) {
+        return 0;
+    }
+    long wait = 0;
+    if (bucket->blocked) {
+        long left = (long) bucket->blockedFor - (long) (millis() - bucket->blockedSince);
+        if (left > 0) {
+            wait = left;
+        } else {
+            bucket->blocked = false;
+        }
+    }
+    if (bucket->perMs > 0) {
+        refill(*bucket);
+        // A request can never cost more than the bucket holds
+        float needed = min((float) cost, bucket->capacity) - bucket->tokens;
+        if (needed > 0) {
+            wait = max(wait, (long) (needed / bucket->perMs) + 1);
+        }
+    }
+    return wait;
+}
+
+bool ApiQuota::acquire(const String &host, uint16_t cost) {
+    long wait = getMillisToAvailable(host, cost);
+    if (wait > 0) {
+        Serial.printf("Quota: %s available again in %ld s\n", host.c_str(), wait / 1000);
+        return false;
+    }
+    Bucket *bucket = find(host);
+    if (bucket != nullptr && bucket->perMs > 0) {
+        bucket->tokens = max(0.0f, bucket->tokens - cost);
+    }
+    return true;
+}
+
+void ApiQuota::handleResponse(const String &host, HTTPClient &http, int httpCode) {
+    unsigned long block = 0;
+    if (httpCode == 429) {
+        long retryAfter = http.header("Retry-After").toInt();
+        block = retryAfter > 0 ? retryAfter * 1000 : QUOTA_BLOCK_DEFAULT;
+    }
+    String remaining = http.header("X-RateLimit-Remaining");
+    if (remaining.isEmpty()) {
+        remaining = http.header("api-credits-left");
+    }
+    if (!remaining.isEmpty()) {
+        long left = remaining.toInt();
+        Bucket *bucket = find(host);
+        if (bucket != nullptr && bucket->perMs > 0) {
+            // The server knows better, e.g. when the key is shared with other devices
+            refill(*bucket);
+            bucket->tokens = min(bucket->tokens, (float) max(left, 0L));
+        }
+        if (left <= 0 && block == 0) {
+            long reset = http.header("X-RateLimit-Reset").toInt();
+            if (reset > 1000000000) {
+                // A timestamp instead of seconds
+                reset -= time(nullptr);
+            }
+            block = reset > 0 ? reset * 1000 : QUOTA_BLOCK_DEFAULT;
+        }
+    }
+    if (block > 0) {
+        blockFor(host, block);
+    }
+}
+
+void ApiQuota::blockFor(const String &host, unsigned long ms) {
+    Bucket &bucket = m_buckets[host];
+    bucket.blocked = true;
+    bucket.blockedSince = millis();
+    bucket.blockedFor = ms;
+    Serial.printf("Quota: %s rate limited, blocked for %lu s\n", host.c_str(), ms / 1000);
+}
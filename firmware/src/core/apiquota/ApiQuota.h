@@ -0,0 +1,86 @@
+#ifndef API_QUOTA_H
+#define API_QUOTA_H
+
+#include <Arduino.h>
+#include <HTTPClient.h>
+#include <map>
+
+class InflateStream;
+
+// Hosts of the rate limited APIs with the shared keys from config_helper.h
+#define QUOTA_HOST_TWELVEDATA "api.twelvedata.com"
+#define QUOTA_HOST_VISUALCROSSING "weather.visualcrossing.com"
+#define QUOTA_HOST_TIMEZONEDB "api.timezonedb.com"
+
+// Budgets of the free plans: requests (or credits/records) per day and how many may be used at once
+#ifndef QUOTA_TWELVEDATA_DAILY
+    #define QUOTA_TWELVEDATA_DAILY 800
+#endif
+#ifndef QUOTA_TWELVEDATA_BURST
+    #define QUOTA_TWELVEDATA_BURST 8 // Credits per minute
+#endif
+#ifndef QUOTA_VISUALCROSSING_DAILY
+    #define QUOTA_VISUALCROSSING_DAILY 1000 // Records, every day of a forecast is one
+#endif
+#ifndef QUOTA_VISUALCROSSING_BURST
+    #define QUOTA_VISUALCROSSING_BURST 20
+#endif
+
+// How long a host is left alone after a 429 without a Retry-After header
+#ifndef QUOTA_BLOCK_DEFAULT
+    #define QUOTA_BLOCK_DEFAULT 60000
+#endif
+
+// HTTP code of fetch() when nothing was sent, HTTPClient uses negative codes for its errors
+#define QUOTA_NOT_SENT 0
+
+// Token buckets for the third-party APIs. Every bucket refills at the daily budget spread evenly
+// over the day and holds at most a burst, so fetches can't use up the quota early in the day.
+// fetch() acquires before every request and passes the response to handleResponse(),
+// which blocks the host after a 429 and follows the rate limit headers.
+// Hosts without a budget are only blocked after a 429.
+class ApiQuota {
+public:
+    static ApiQuota *getInstance();
+
+    // GET url if EndpointHealth allows it and the quota has cost tokens left, with a compressed
+    // body and the rate limit headers. Reports the outcome to EndpointHealth (a code from 500 or
+    // no answer is a failure) and handleResponse(). Returns the HTTP code or QUOTA_NOT_SENT.
+    // Read the response with body.begin(http.getStream()) and call http.end() if it was sent.
+    static int fetch(const String &host, uint16_t cost, const String &url, HTTPClient &http, InflateStream &body);
+
+    // Tell the HTTPClient to keep the rate limit headers, call before GET()
+    static void collectHeaders(HTTPClient &http);
+
+    // Take cost tokens for a request to host, false if the request has to wait
+    bool acquire(const String &host, uint16_t cost = 1);
+    // Time until acquire() succeeds, for getMillisToNextUpdate()
+    long getMillisToAvailable(const String &host, uint16_t cost = 1);
+    // Look at the status and the rate limit headers of a response
+    void handleResponse(const String &host, HTTPClient &http, int httpCode);
+    // Don't send anything to host for ms, e.g. after an error in the response body
+    void blockFor(const String &host, unsigned long ms);
+
+private:
+    struct Bucket {
+        float capacity = 0;
+        float tokens = 0;
+        float perMs = 0; // Refill rate, 0 = no budget
+        unsigned long lastRefill = 0;
+        bool blocked = false;
+        unsigned long blockedSince = 0;
+        unsigned long blockedFor = 0;
+    };
+
+    ApiQuota();
+
+    void define(const String &host, float daily, float burst);
+    Bucket *find(const String &host);
+    void refill(Bucket &bucket);
+
+    static ApiQuota *m_instance;
+
+    std::map<String, Bucket> m_buckets;
+};
+
+#endif // API_QUOTA_H
@@ -0,0 +1,88 @@
+#include "EndpointHealth.h"
+
+#include <WiFi.h>
+#include <climits>
+
+EndpointHealth *EndpointHealth::m_instance = nullptr;
+
+EndpointHealth *EndpointHealth::getInstance() {
+    if (m_instance == nullptr) {
+        m_instance = new EndpointHealth();
+    }
+    return m_instance;
+}
+
+String EndpointHealth::hostOf(const String &url) {
+    int start = url.indexOf("://");
+    start = start < 0 ? 0 : start + 3;
+    int end = url.indexOf('/', start);
+    return end < 0 ? url.substring(start) : url.substring(start, end);
+}
+
+bool EndpointHealth::allow(const String &host) {
+    if (WiFi.status() != WL_CONNECTED) {
+        return false;
+    }
+    auto it = m_endpoints.find(host);
+    if (it == m_endpoints.end() || it->second.failures == 0) {
+        return true;
+    }
+    Endpoint &endpoint = it->second;
+    if (millis() - endpoint.failedAt < endpoint.retryDelay) {
+        return false;
+    }
+    if (endpoint.state == OPEN) {
+        endpoint.state = HALF_OPEN;
+        Serial.printf("Health: probing %s\n", host.c_str());
+    }
+    return true;
+}
+
+long EndpointHealth::getMillisToRetry(const String &host) {
+    if (WiFi.status() != WL_CONNECTED) {
+        // The WiFi events wake up the main loop
+        return LONG_MAX;
+    }
+    auto it = m_endpoints.find(host);
+    if (it == m_endpoints.end() || it->second.failures == 0) {
+        return 0;
+    }
+    long wait = (long) it->second.retryDelay - (long) (millis() - it->second.failedAt);
+    return wait > 0 ? wait : 0;
+}
+
+void EndpointHealth::success(const String &host) {
+    auto it = m_endpoints.find(host);
+    if (it == m_endpoints.end() || it->second.failures == 0) {
+        return;
+    }
+    if (it->second.state != CLOSED) {
+        Serial.printf("Health: %s is back after %d failures\n", host.c_str(), it->second.failures);
+    }
+    m_endpoints.erase(it);
+}
+
+void EndpointHealth::failure(const String &host) {
+    if (WiFi.status() != WL_CONNECTED) {
+        // Not the fault of the endpoint
+        return;
+    }
+    Endpoint &endpoint = m_endpoints[host];
+    if (endpoint.failures < UINT8_MAX) {
+        endpoint.failures++;
+    }
+    unsigned long delay = (unsigned long) HEALTH_BACKOFF_MIN << min(endpoint.failures - 1, 16);
+    if (delay > HEALTH_BACKOFF_MAX) {
+        delay = HEALTH_BACKOFF_MAX;
+    }
+    // +-25%, so devices that share an API key don't all come back at the same time
+    endpoint.retryDelay = delay * (75 + random(51)) / 100;
+    endpoint.failedAt = millis();
+    if (endpoint.failures >= HEALTH_FAILURE_THRESHOLD) {
+        if (endpoint.state == CLOSED) {
+            Serial.printf("Health: %s is down\n", host.c_str());
+        }
+        endpoint.state = OPEN;
+        Serial.printf("Health: next try for %s in %lu s\n", host.c_str(), endpoint.retryDelay / 1000);
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef ENDPOINT_HEALTH_H
+#define ENDPOINT_HEALTH_H
+
+#include <Arduino.h>
+#include <map>
+
+// Failures in a row after which an endpoint counts as down
+#ifndef HEALTH_FAILURE_THRESHOLD
+    #define HEALTH_FAILURE_THRESHOLD 3
+#endif
+
+// Wait after the first failure, doubled with every further one up to HEALTH_BACKOFF_MAX
+#ifndef HEALTH_BACKOFF_MIN
+    #define HEALTH_BACKOFF_MIN 5000
+#endif
+#ifndef HEALTH_BACKOFF_MAX
+    #define HEALTH_BACKOFF_MAX 1800000
+#endif
+
+// Circuit breaker per API host. After a failure the host is left alone for an exponentially
+// growing, jittered time. After HEALTH_FAILURE_THRESHOLD failures in a row the circuit opens:
+// no request is sent until the backoff passed, then a single probe decides (half-open)
+// whether it closes again or stays open for twice as long.
+// A host that is down costs nothing but this check, instead of a connect timeout on every pass.
+class EndpointHealth {
+public:
+    static EndpointHealth *getInstance();
+
+    // Host (and port) of an URL, the key for the other methods
+    static String hostOf(const String &url);
+
+    // Whether a request to host may be sent now, false without WiFi as well
+    bool allow(const String &host);
+    // Time until allow() returns true again, for getMillisToNextUpdate()
+    long getMillisToRetry(const String &host);
+    void success(const String &host);
+    void failure(const String &host);
+
+private:
+    enum State {
+        CLOSED,
+        OPEN,
+        HALF_OPEN
+    };
+    struct Endpoint {
+        State state = CLOSED;
+        uint8_t failures = 0; // In a row
+        unsigned long failedAt = 0;
+        unsigned long retryDelay = 0;
+    };
+
+    EndpointHealth() = default;
+
+    static EndpointHealth *m_instance;
+
+    std::map<String, Endpoint> m_endpoints;
+};
+
+#endif // ENDPOINT_HEALTH_H
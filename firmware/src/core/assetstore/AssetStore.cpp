@@ -0,0 +1,132 @@
+#include "AssetStore.h"
+
+#ifdef ESP32
+    #include <esp_partition.h>
+#else
+    // Host builds map a file instead of the partition
+    #include <cstdio>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+// Store layout (little endian), written by tools/pack_assets.py:
+//   header: "ASST", version (2 bytes), asset count (2 bytes), store size (4 bytes), 4 reserved bytes
+//   index:  one entry per asset, sorted by name: name (56 bytes, zero padded), offset (4 bytes), size (4 bytes)
+//   data:   the assets, 4 byte aligned
+#define ASSET_STORE_VERSION 1
+#define ASSET_STORE_HEADER_SIZE 16
+#define ASSET_STORE_NAME_SIZE 56
+#define ASSET_STORE_ENTRY_SIZE 64
+#define ASSET_STORE_SUBTYPE 0x40
+
+const byte *AssetStore::m_data = nullptr;
+size_t AssetStore::m_size = 0;
+uint16_t AssetStore::m_count = 0;
+bool AssetStore::m_mapped = false;
+
+static uint32_t read32(const byte *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+bool AssetStore::begin(const char *path) {
+    if (!map(path)) {
+        Serial.printf("AssetStore: no assets found, flash them with: pio run -e esp32doit-devkit-v1-assets -t uploadassets\n");
+        return false;
+    }
+    Serial.printf("AssetStore: %d assets, %d bytes\n", m_count, (int) m_size);
+    return true;
+}
+
+// Map the store once (also called lazily on the first lookup, e.g. by the host benchmark)
+bool AssetStore::map(const char *path) {
+    if (m_mapped) {
+        return m_data != nullptr;
+    }
+    m_mapped = true;
+
+    const void *data = nullptr;
+    size_t size = 0;
+#ifdef ESP32
+    (void) path;
+    const esp_partition_t *partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t) ASSET_STORE_SUBTYPE, "assets");
+    spi_flash_mmap_handle_t handle;
+    if (partition == nullptr || esp_partition_mmap(partition, 0, partition->size, SPI_FLASH_MMAP_DATA, &data, &handle) != ESP_OK) {
+        return false;
+    }
+    size = partition->size;
+#else
+    if (path == nullptr) {
+        path = getenv("ASSET_STORE_FILE");
+    }
+    int fd = path ? open(path, O_RDONLY) : -1;
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size == 0) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        return false;
+    }
+    size = st.st_size;
+    data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+#endif
+
+    // An erased partition reads as 0xFF
+    const byte *header = (const byte *) data;
+    if (size < ASSET_STORE_HEADER_SIZE || memcmp(header, "ASST", 4) != 0 || (header[4] | (header[5] << 8)) != ASSET_STORE_VERSION) {
+        return false;
+    }
+    uint16_t count = header[6] | (header[7] << 8);
+    uint32_t storeSize = read32(header + 8);
+    if (storeSize > size || ASSET_STORE_HEADER_SIZE + count * ASSET_STORE_ENTRY_SIZE > storeSize) {
+        return false;
+    }
+    m_data = header;
+    m_size = storeSize;
+    m_count = count;
+    return true;
+}
+
+const byte *AssetStore::find(const char *name, size_t *size) {
+    *size = 0;
+    if (!map(nullptr)) {
+        return nullptr;
+    }
+    int lo = 0;
+    int hi = m_count - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        const byte *entry = m_data + ASSET_STORE_HEADER_SIZE + mid * ASSET_STORE_ENTRY_SIZE;
+        int cmp = strncmp(name, (const char *) entry, ASSET_STORE_NAME_SIZE);
+        if (cmp == 0) {
+            uint32_t offset = read32(entry + ASSET_STORE_NAME_SIZE);
+            uint32_t assetSize = read32(entry + ASSET_STORE_NAME_SIZE + 4);
+            if (offset > m_size || assetSize > m_size - offset) {
+                return nullptr;
+            }
+            *size = assetSize;
+            return m_data + offset;
+        } else if (cmp > 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return nullptr;
+}
+
+const byte *AssetStore::start(const char *name) {
+    size_t size;
+    return find(name, &size);
+}
+
+const byte *AssetStore::end(const char *name) {
+    size_t size;
+    const byte *data = find(name, &size);
+    return data ? data + size : nullptr;
+}
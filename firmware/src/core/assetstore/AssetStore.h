@@ -0,0 +1,53 @@
+#ifndef ASSETSTORE_H
+#define ASSETSTORE_H
+
+#include <Arduino.h>
+
+// Fonts and images packed into the assets partition by tools/pack_assets.py (only with ASSET_STORE).
+// The partition is memory mapped, so assets are used in place like embedded files.
+class AssetStore {
+public:
+    // Map the store and log its content. On the host (tools/bench) the store is read from a file instead.
+    static bool begin(const char *path = nullptr);
+
+    // Assets are named like the linker symbols of embedded files without "_binary_" (e.g. "fonts_subset_RobotoRegular_ttf").
+    // Returns nullptr (and size 0) if the asset is not in the store.
+    static const byte *find(const char *name, size_t *size);
+    static const byte *start(const char *name);
+    static const byte *end(const char *name);
+
+private:
+    static bool map(const char *path);
+
+    static const byte *m_data;
+    static size_t m_size;
+    static uint16_t m_count;
+    static bool m_mapped;
+};
+
+// Declares <name>_start() and <name>_end() for a file from board_build.embed_files (or custom_assets with ASSET_STORE).
+// With ASSET_STORE the asset is looked up on the first call (after AssetStore::begin()) and remembered,
+// nullptr if the store doesn't have it.
+#ifdef ASSET_STORE
+    #define EMBEDDED_ASSET(name, symbol)                                \
+        inline const byte *name##_start() {                             \
+            static const byte *const start = AssetStore::start(symbol); \
+            return start;                                               \
+        }                                                               \
+        inline const byte *name##_end() {                               \
+            static const byte *const end = AssetStore::end(symbol);     \
+            return end;                                                 \
+        }
+#else
+    #define EMBEDDED_ASSET(name, symbol)                                         \
+        extern const byte name##_start_symbol[] asm("_binary_" symbol "_start"); \
+        extern const byte name##_end_symbol[] asm("_binary_" symbol "_end");     \
+        inline const byte *name##_start() {                                      \
+            return name##_start_symbol;                                          \
+        }                                                                        \
+        inline const byte *name##_end() {                                        \
+            return name##_end_symbol;                                            \
+        }
+#endif
+
+#endif
@@ -3,68 +3,102 @@
 
 /**
  * After calling begin() make sure to attach an interrupt handler in main.cpp that will call isrButtonChange()
+ * The ISR only queues timestamped press/release events, they are classified in getState() from the main loop
  */
 Button::Button(uint8_t pin)
     : m_pin(pin), m_lastPinLevelChange(0),
       m_pinLevel(RELEASED_LEVEL), m_state(BTN_NOTHING),
-      m_hasChanged(false) {}
+      m_pressedSince(0), m_eventTime(0) {}
 
 void Button::begin() {
     pinMode(m_pin, BUTTON_MODE);
 }
 
 void Button::isrButtonChange() {
-    if (millis() - m_lastPinLevelChange < DEBOUNCE_TIME) {
+    unsigned long now = millis();
+    if (now - m_lastPinLevelChange < DEBOUNCE_TIME) {
         return;
     }
 
     bool newPinLevel = digitalRead(m_pin);
     if (newPinLevel != m_pinLevel) {
         m_pinLevel = newPinLevel;
-        m_lastPinLevelChange = millis();
-        if (m_pinLevel == RELEASED_LEVEL) {
-            // Button was now released
-            // We now check if this was a short, medium or long press
-            if (millis() - m_pressedSince >= LONG_PRESS_TIME) {
-                m_state = BTN_LONG;
-            } else if (millis() - m_pressedSince >= MEDIUM_PRESS_TIME) {
-                m_state = BTN_MEDIUM;
-            } else {
-                m_state = BTN_SHORT;
-            }
-        } else {
-            // Start button press
-            m_pressedSince = millis();
-            m_state = BTN_NOTHING;
+        m_lastPinLevelChange = now;
+        uint8_t head = m_eventHead.load(std::memory_order_relaxed);
+        if ((uint8_t) (head - m_eventTail.load(std::memory_order_acquire)) < EVENT_QUEUE_SIZE) {
+            m_events[head & (EVENT_QUEUE_SIZE - 1)] = {m_pinLevel == PRESSED_LEVEL, now};
+            m_eventHead.store(head + 1, std::memory_order_release);
         }
-        m_hasChanged = true;
+        // else the queue is full, drop the event (we'd need more than 8 unhandled presses)
     }
 }
 
-bool Button::has_changed() {
-    if (m_hasChanged == true) {
-        m_hasChanged = false;
-        return true;
+bool Button::popEvent(ButtonEvent &event) {
+    uint8_t tail = m_eventTail.load(std::memory_order_relaxed);
+    if (tail == m_eventHead.load(std::memory_order_acquire)) {
+        return false;
     }
-    return false;
+    event = m_events[tail & (EVENT_QUEUE_SIZE - 1)];
+    m_eventTail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+// Returns the next completed press without consuming it
+ButtonState Button::peekState() {
+    ButtonEvent event;
+    while (m_state == BTN_NOTHING && popEvent(event)) {
+        if (event.pressed) {
+            // Start button press
+            m_pressedSince = event.time;
+            continue;
+        }
+        // Button was now released
+        // We now check if this was a short, medium or long press
+        unsigned long duration = event.time - m_pressedSince;
+        if (duration >= LONG_PRESS_TIME) {
+            m_state = BTN_LONG;
+        } else if (duration >= MEDIUM_PRESS_TIME) {
+            m_state = BTN_MEDIUM;
+        } else {
+            m_state = BTN_SHORT;
+        }
+        m_eventTime = event.time;
+    }
+    return m_state;
 }
 
 bool Button::pressedShort() {
-    return (m_state == BTN_SHORT && has_changed());
+    if (peekState() == BTN_SHORT) {
+        m_state = BTN_NOTHING;
+        return true;
+    }
+    return false;
 }
 
 bool Button::pressedMedium() {
-    return (m_state == BTN_MEDIUM && has_changed());
+    if (peekState() == BTN_MEDIUM) {
+        m_state = BTN_NOTHING;
+        return true;
+    }
+    return false;
 }
 
 bool Button::pressedLong() {
-    return (m_state == BTN_LONG && has_changed());
+    if (peekState() == BTN_LONG) {
+        m_state = BTN_NOTHING;
+        return true;
+    }
+    return false;
 }
 
+// Returns and consumes the next completed press, call repeatedly until BTN_NOTHING to handle all queued presses
 ButtonState Button::getState() {
-    if (has_changed()) {
-        return m_state;
-    } else {
-        return BTN_NOTHING;
-    }
-}
\ No newline at end of file
+    ButtonState state = peekState();
+    m_state = BTN_NOTHING;
+    return state;
+}
+
+// Time (millis) the last returned press was released, to measure input latency
+unsigned long Button::getEventTime() {
+    return m_eventTime;
+}
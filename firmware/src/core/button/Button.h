@@ -1,6 +1,7 @@
 #ifndef BUTTON_H
 #define BUTTON_H
 #include <Arduino.h>
+#include <atomic>
 
 enum ButtonState {
     BTN_NOTHING,
@@ -17,6 +18,7 @@ public:
     bool pressedMedium();
     bool pressedLong();
     ButtonState getState();
+    unsigned long getEventTime();
     void isrButtonChange();
 
 #if BUTTON_MODE == INPUT_PULLDOWN
@@ -43,15 +45,31 @@ public:
     const static unsigned long LONG_PRESS_TIME = 2000;
 #endif
 
+    // Number of queued press/release events, must be a power of 2
+    const static uint8_t EVENT_QUEUE_SIZE = 16;
+
 private:
+    struct ButtonEvent {
+        bool pressed;
+        unsigned long time;
+    };
+
     uint8_t m_pin;
     volatile bool m_pinLevel;
-    volatile ButtonState m_state;
-    volatile bool m_hasChanged;
     volatile unsigned long m_lastPinLevelChange;
-    volatile unsigned long m_pressedSince;
 
-    bool has_changed();
+    // Single producer (ISR), single consumer (main loop) ring buffer
+    ButtonEvent m_events[EVENT_QUEUE_SIZE];
+    std::atomic<uint8_t> m_eventHead{0}; // Written by the ISR only
+    std::atomic<uint8_t> m_eventTail{0}; // Written by the main loop only
+
+    // Classification state, only touched by the main loop
+    ButtonState m_state;
+    unsigned long m_pressedSince;
+    unsigned long m_eventTime;
+
+    bool popEvent(ButtonEvent &event);
+    ButtonState peekState();
 };
 
 #endif // BUTTON_H
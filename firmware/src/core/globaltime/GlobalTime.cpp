@@ -1,18 +1,30 @@
 #include "GlobalTime.h"
 
+#include "ApiQuota.h"
+#include "InflateStream.h"
 #include "config_helper.h"
 #include <TimeLib.h>
+#include <esp_sntp.h>
 
 GlobalTime *GlobalTime::m_instance = nullptr;
 
 GlobalTime::GlobalTime() {
-    m_timeClient = new NTPClient(m_udp);
-    m_timeClient->begin();
-    m_timeClient->setPoolServerName(NTP_SERVER);
+    // Let SNTP keep the system clock in UTC with sub-second precision
+    // Corrections are slewed (adjtime) so the clock never jumps or runs backwards, only large errors are stepped
+    sntp_set_sync_mode(SNTP_SYNC_MODE_SMOOTH);
+    configTime(0, 0, NTP_SERVER);
+#ifdef TIMEZONE_POSIX
+    m_hasTimeZoneRule = m_timeZoneRule.parse(TIMEZONE_POSIX);
+#else
+    m_hasTimeZoneRule = m_timeZoneRule.setLocation(TIMEZONE_API_LOCATION);
+#endif
+    if (!m_hasTimeZoneRule) {
+        Serial.println("Timezone not found in compiled-in rules, falling back to API");
+    }
 }
 
 GlobalTime::~GlobalTime() {
-    delete m_timeClient;
+    sntp_stop();
 }
 
 GlobalTime *GlobalTime::getInstance() {
@@ -23,29 +35,78 @@ GlobalTime *GlobalTime::getInstance() {
 }
 
 void GlobalTime::updateTime() {
-    if (millis() - m_updateTimer > m_oneSecond) {
+    struct timeval now;
+    gettimeofday(&now, nullptr);
+    // Nothing changes until the next second edge
+    if (now.tv_sec != m_utc) {
+        m_utc = now.tv_sec;
         if (m_timeZoneOffset == -1 || (m_nextTimeZoneUpdate > 0 && m_unixEpoch > m_nextTimeZoneUpdate)) {
-            getTimeZoneOffsetFromAPI();
+            updateTimeZoneOffset();
+        }
+#ifdef BENCHMARK
+        unsigned long start = micros();
+#endif
+        m_unixEpoch = m_utc + (m_timeZoneOffset == -1 ? 0 : m_timeZoneOffset);
+        m_second = m_unixEpoch % 60;
+        // Everything else only changes when the minute rolls over
+        if (m_unixEpoch / 60 != m_lastMinute) {
+            updateMinute();
         }
-        m_timeClient->update();
-        m_unixEpoch = m_timeClient->getEpochTime();
-        m_updateTimer = millis();
-        m_minute = minute(m_unixEpoch);
-        if (m_format24hour) {
-            m_hour = hour(m_unixEpoch);
+#ifdef BENCHMARK
+        m_benchmarkTotal += micros() - start;
+        if (++m_benchmarkCount == 60) {
+            Serial.printf("GlobalTime update took %lu us on average\n", m_benchmarkTotal / m_benchmarkCount);
+            m_benchmarkTotal = 0;
+            m_benchmarkCount = 0;
+        }
+#endif
+    }
+}
+
+void GlobalTime::updateMinute() {
+    m_lastMinute = m_unixEpoch / 60;
+    m_minute = m_lastMinute % 60;
+    m_hour24 = (m_unixEpoch / 3600) % 24;
+    if (m_format24hour) {
+        m_hour = m_hour24;
+    } else {
+        m_hour = m_hour24 % 12 == 0 ? 12 : m_hour24 % 12;
+    }
+    snprintf(m_hourPadded, sizeof(m_hourPadded), "%02d", m_hour);
+    snprintf(m_minutePadded, sizeof(m_minutePadded), "%02d", m_minute);
+    snprintf(m_time, sizeof(m_time), "%d:%02d", m_hour, m_minute);
+
+    if (m_unixEpoch / 86400 != m_lastDay) {
+        updateDay();
+    }
+}
+
+void GlobalTime::updateDay() {
+    m_lastDay = m_unixEpoch / 86400;
+    m_day = day(m_unixEpoch);
+    m_month = month(m_unixEpoch);
+    m_monthName = LOC_MONTH[m_month - 1];
+    m_year = year(m_unixEpoch);
+    m_weekday = LOC_WEEKDAY[(weekday(m_unixEpoch)) - 1];
+
+#ifdef WEATHER_UNITS_METRIC
+    const char *format = LOC_FORMAT_DAYMONTH;
+#else
+    const char *format = "%B %d";
+#endif
+    // Expand %d and %B, everything else is copied as is
+    size_t len = 0;
+    for (const char *p = format; *p && len < sizeof(m_dayAndMonth) - 1; p++) {
+        if (p[0] == '%' && (p[1] == 'd' || p[1] == 'B')) {
+            int written = p[1] == 'd' ? snprintf(m_dayAndMonth + len, sizeof(m_dayAndMonth) - len, "%d", m_day)
+                                      : snprintf(m_dayAndMonth + len, sizeof(m_dayAndMonth) - len, "%s", m_monthName);
+            len = min(len + written, sizeof(m_dayAndMonth) - 1);
+            p++;
         } else {
-            m_hour = hourFormat12(m_unixEpoch);
+            m_dayAndMonth[len++] = *p;
         }
-        m_hour24 = hour(m_unixEpoch);
-        m_second = second(m_unixEpoch);
-
-        m_day = day(m_unixEpoch);
-        m_month = month(m_unixEpoch);
-        m_monthName = LOC_MONTH[m_month - 1];
-        m_year = year(m_unixEpoch);
-        m_weekday = LOC_WEEKDAY[(weekday(m_unixEpoch)) -1];
-        m_time = String(m_hour) + ":" + (m_minute < 10 ? "0" + String(m_minute) : String(m_minute));
     }
+    m_dayAndMonth[len] = '\0';
 }
 
 void GlobalTime::getHourAndMinute(int &hour, int &minute) {
@@ -61,24 +122,16 @@ int GlobalTime::getHour24() {
     return m_hour24;
 }
 
-String GlobalTime::getHourPadded() {
-    if (m_hour < 10) {
-        return "0" + String(m_hour);
-    } else {
-        return String(m_hour);
-    }
+const char *GlobalTime::getHourPadded() {
+    return m_hourPadded;
 }
 
 int GlobalTime::getMinute() {
     return m_minute;
 }
 
-String GlobalTime::getMinutePadded() {
-    if (m_minute < 10) {
-        return "0" + String(m_minute);
-    } else {
-        return String(m_minute);
-    }
+const char *GlobalTime::getMinutePadded() {
+    return m_minutePadded;
 }
 
 int GlobalTime::getSecond() {
@@ -89,6 +142,13 @@ time_t GlobalTime::getUnixEpoch() {
     return m_unixEpoch;
 }
 
+// Time until the next second edge, so callers can tick exactly on it instead of polling
+int GlobalTime::getMillisToNextSecond() {
+    struct timeval now;
+    gettimeofday(&now, nullptr);
+    return 1000 - now.tv_usec / 1000;
+}
+
 int GlobalTime::getDay() {
     return m_day;
 }
@@ -97,7 +157,7 @@ int GlobalTime::getMonth() {
     return m_month;
 }
 
-String GlobalTime::getMonthName() {
+const char *GlobalTime::getMonthName() {
     return m_monthName;
 }
 
@@ -105,39 +165,53 @@ int GlobalTime::getYear() {
     return m_year;
 }
 
-String GlobalTime::getTime() {
+const char *GlobalTime::getTime() {
     return m_time;
 }
 
-String GlobalTime::getWeekday() {
+const char *GlobalTime::getWeekday() {
     return m_weekday;
 }
 
-String GlobalTime::getDayAndMonth() {
-#ifdef WEATHER_UNITS_METRIC
-    String retVal = LOC_FORMAT_DAYMONTH;
-    retVal.replace("%d", String(m_day));
-    retVal.replace("%B", m_monthName);
-    return retVal;
-#else
-    return m_monthName + " " + String(m_day);
-#endif
+const char *GlobalTime::getDayAndMonth() {
+    return m_dayAndMonth;
 }
 
 #include <HTTPClient.h> // Include the necessary header file
 
 bool GlobalTime::isPM() {
-    return hour(m_unixEpoch) >= 12;
+    return m_hour24 >= 12;
+}
+
+void GlobalTime::updateTimeZoneOffset() {
+    if (!m_hasTimeZoneRule) {
+        getTimeZoneOffsetFromAPI();
+        return;
+    }
+    if (m_utc < 1700000000) {
+        // Wait for NTP, the clock starts at 1970 and the rules need the current date
+        return;
+    }
+    time_t nextChange;
+    m_timeZoneOffset = m_timeZoneRule.getOffset(m_utc, nextChange);
+    // Compared against local time in updateTime()
+    m_nextTimeZoneUpdate = nextChange == 0 ? 0 : nextChange + m_timeZoneOffset;
+    Serial.printf("Timezone Offset from rules: %d, next change: %lu\n", m_timeZoneOffset, m_nextTimeZoneUpdate);
 }
 
 void GlobalTime::getTimeZoneOffsetFromAPI() {
+    // Called every second until there is an offset, the quota and the backoff keep it within the API limits
     HTTPClient http;
-    http.begin(String(TIMEZONE_API_URL) + "?key=" + TIMEZONE_API_KEY + "&format=json&fields=gmtOffset,zoneEnd&by=zone&zone=" + String(TIMEZONE_API_LOCATION));
-    int httpCode = http.GET();
+    InflateStream body;
+    int httpCode = ApiQuota::fetch(QUOTA_HOST_TIMEZONEDB, 1, String(TIMEZONE_API_URL) + "?key=" + TIMEZONE_API_KEY + "&format=json&fields=gmtOffset,zoneEnd&by=zone&zone=" + String(TIMEZONE_API_LOCATION), http, body);
+    if (httpCode == QUOTA_NOT_SENT) {
+        return;
+    }
 
     if (httpCode > 0) {
         JsonDocument doc;
-        DeserializationError error = deserializeJson(doc, http.getString());
+        body.begin(http.getStream());
+        DeserializationError error = deserializeJson(doc, body);
         if (!error) {
             m_timeZoneOffset = doc["gmtOffset"].as<int>();
             if (doc["zoneEnd"].isNull()) {
@@ -151,7 +225,6 @@ void GlobalTime::getTimeZoneOffsetFromAPI() {
             Serial.println(m_timeZoneOffset);
             Serial.print("Next timezone update: ");
             Serial.println(m_nextTimeZoneUpdate);
-            m_timeClient->setTimeOffset(m_timeZoneOffset);
         } else {
             Serial.println("Deserialization error on timezone offset API response");
         }
@@ -166,5 +239,6 @@ bool GlobalTime::getFormat24Hour() {
 
 bool GlobalTime::setFormat24Hour(bool format24hour) {
     m_format24hour = format24hour;
+    updateMinute();
     return m_format24hour;
 }
\ No newline at end of file
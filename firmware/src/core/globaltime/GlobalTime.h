@@ -1,11 +1,12 @@
 #ifndef TIME_H
 #define TIME_H
 
+#include "TimeZoneRule.h"
 #include "config_helper.h"
 #include <ArduinoJson.h>
 #include <HTTPClient.h>
-#include <NTPClient.h>
 #include <TimeLib.h>
+#include <sys/time.h>
 
 // Define locales
 #define EN 0
@@ -15,17 +16,17 @@
 #if LOCALE == DE // German
 const char LOC_MONTH[12][10] = {"Januar", "Februar", "Maerz", "April", "Mai", "Juni", "Juli", "August", "September", "Oktober", "November", "Dezember"}; // Define german for month
 const char LOC_WEEKDAY[7][11] = {"Sonntag", "Montag", "Dienstag", "Mittwoch", "Donnerstag", "Freitag", "Samstag"}; // Define german for weekday
-const String LOC_FORMAT_DAYMONTH = "%d. %B"; // in strftime format
+const char LOC_FORMAT_DAYMONTH[] = "%d. %B"; // in strftime format
 const String LOC_LANG = "de";
 #elif LOCALE == FR // French
 const char LOC_MONTH[12][10] = {"Janvier", "Fevrier", "Mars", "Avril", "Mai", "Juin", "Juillet", "Aout", "Septembre", "Octobre", "Novembre", "Decembre"}; // Define french for month
 const char LOC_WEEKDAY[7][11] = {"Lundi", "Mardi", "Mercredi", "Jeudi", "Vendredi", "Samedi", "Dimanche"}; // Define french for weekday
-const String LOC_FORMAT_DAYMONTH = "%d %B"; // in strftime format
+const char LOC_FORMAT_DAYMONTH[] = "%d %B"; // in strftime format
 const String LOC_LANG = "fr";
 #else // English
 const char LOC_MONTH[12][10] = {"January", "February", "March", "April", "May", "June", "July", "August", "September", "October", "November", "December"}; // Define english for month
 const char LOC_WEEKDAY[7][11] = {"Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"}; // Define english for weekday
-const String LOC_FORMAT_DAYMONTH = "%d %B"; // in strftime format, this will be overriden if WEATHER_UNITS_METRIC is not set
+const char LOC_FORMAT_DAYMONTH[] = "%d %B"; // in strftime format, this will be overriden if WEATHER_UNITS_METRIC is not set
 const String LOC_LANG = "en";
 #endif
 
@@ -37,18 +38,19 @@ public:
     void getHourAndMinute(int &hour, int &minute);
     int getHour();
     int getHour24();
-    String getHourPadded();
+    const char *getHourPadded();
     int getMinute();
-    String getMinutePadded();
+    const char *getMinutePadded();
     time_t getUnixEpoch();
+    int getMillisToNextSecond();
     int getSecond();
     int getDay();
     int getMonth();
-    String getMonthName();
+    const char *getMonthName();
     int getYear();
-    String getTime();
-    String getWeekday();
-    String getDayAndMonth();
+    const char *getTime();
+    const char *getWeekday();
+    const char *getDayAndMonth();
     bool isPM();
     bool getFormat24Hour();
     bool setFormat24Hour(bool format24hour);
@@ -59,28 +61,39 @@ private:
 
     static GlobalTime *m_instance;
 
-    time_t m_unixEpoch;
+    time_t m_utc = -1; // UTC second the local fields below were computed for
+    time_t m_unixEpoch = 0;
+    time_t m_lastMinute = -1; // Minute (since epoch) the fields below were computed for
+    time_t m_lastDay = -1; // Day (since epoch) the date fields were computed for
     int m_hour = 0;
     int m_hour24 = 0;
     int m_minute = 0;
     int m_second = 0;
     int m_day = 0;
     int m_month = 0;
-    String m_monthName;
+    const char *m_monthName = "";
     int m_year = 0;
-    String m_time;
-    String m_weekday;
+    const char *m_weekday = "";
+    // Formatted fields are kept in fixed buffers so callers don't cause heap traffic
+    char m_time[6] = "";
+    char m_hourPadded[3] = "";
+    char m_minutePadded[3] = "";
+    char m_dayAndMonth[24] = "";
     int m_timeZoneOffset = -1; // A value that will be overwritten by the API
     unsigned long m_nextTimeZoneUpdate = 0;
-
-    WiFiUDP m_udp;
-    NTPClient *m_timeClient{nullptr};
-
-    unsigned long m_oneSecond = 1000;
-    unsigned long m_updateTimer = 0;
+    TimeZoneRule m_timeZoneRule;
+    bool m_hasTimeZoneRule = false; // Offsets are computed locally, no need for the API
 
     bool m_format24hour{FORMAT_24_HOUR};
 
+#ifdef BENCHMARK
+    unsigned long m_benchmarkTotal = 0;
+    int m_benchmarkCount = 0;
+#endif
+
+    void updateMinute();
+    void updateDay();
+    void updateTimeZoneOffset();
     void getTimeZoneOffsetFromAPI();
 };
 
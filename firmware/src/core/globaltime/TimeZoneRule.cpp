@@ -0,0 +1,183 @@
+#include "TimeZoneRule.h"
+
+#include "TimeZones.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+static long daysFromCivil(int y, int m, int d) {
+    y -= m <= 2;
+    long era = (y >= 0 ? y : y - 399) / 400;
+    long yoe = y - era * 400;
+    long doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+static int yearFromDays(long days) {
+    days += 719468;
+    long era = (days >= 0 ? days : days - 146096) / 146097;
+    long doe = days - era * 146097;
+    long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    long mp = (5 * doy + 2) / 153;
+    return yoe + era * 400 + (mp >= 10);
+}
+
+static bool isLeapYear(int y) {
+    return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+}
+
+static int daysInMonth(int y, int m) {
+    static const int days[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return m == 2 && isLeapYear(y) ? 29 : days[m - 1];
+}
+
+static const char *parseName(const char *p) {
+    if (*p == '<') {
+        const char *end = strchr(p, '>');
+        return end ? end + 1 : nullptr;
+    }
+    const char *start = p;
+    while (isalpha(*p)) {
+        p++;
+    }
+    return p - start >= 3 ? p : nullptr;
+}
+
+// Parses [+-]hh[:mm[:ss]] into seconds
+static const char *parseTime(const char *p, long &seconds) {
+    int sign = 1;
+    if (*p == '+' || *p == '-') {
+        sign = *p == '-' ? -1 : 1;
+        p++;
+    }
+    if (!isdigit(*p)) {
+        return nullptr;
+    }
+    char *end;
+    seconds = strtol(p, &end, 10) * 3600;
+    for (int factor = 60; *end == ':' && factor >= 1; factor /= 60) {
+        seconds += strtol(end + 1, &end, 10) * factor;
+    }
+    seconds *= sign;
+    return end;
+}
+
+// Looks up an IANA zone name (e.g. "Europe/Berlin") in the compiled-in table
+bool TimeZoneRule::setLocation(const char *location) {
+    int lo = 0;
+    int hi = TIME_ZONE_COUNT - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        int cmp = strcmp(location, TIME_ZONES[mid].name);
+        if (cmp == 0) {
+            return parse(TIME_ZONES[mid].rule);
+        }
+        if (cmp < 0) {
+            hi = mid - 1;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return false;
+}
+
+bool TimeZoneRule::parse(const char *rule) {
+    const char *p = parseName(rule);
+    if (!p || !(p = parseTime(p, m_stdOffset))) {
+        return false;
+    }
+    // POSIX offsets are west of UTC, we want east
+    m_stdOffset = -m_stdOffset;
+    m_dstOffset = m_stdOffset;
+    m_hasDst = *p != '\0';
+    if (!m_hasDst) {
+        return true;
+    }
+    if (!(p = parseName(p))) {
+        return false;
+    }
+    m_dstOffset = m_stdOffset + 3600;
+    if (*p != ',' && *p != '\0') {
+        if (!(p = parseTime(p, m_dstOffset))) {
+            return false;
+        }
+        m_dstOffset = -m_dstOffset;
+    }
+    if (*p == '\0') {
+        // No rules given, POSIX leaves the default to the implementation, use the US rules
+        p = ",M3.2.0,M11.1.0";
+    }
+    Transition *transitions[2] = {&m_dstStart, &m_dstEnd};
+    for (Transition *t : transitions) {
+        if (*p++ != ',') {
+            return false;
+        }
+        char *end;
+        if (*p == 'M') {
+            t->type = 'M';
+            t->month = strtol(p + 1, &end, 10);
+            t->week = strtol(end + 1, &end, 10);
+            t->day = strtol(end + 1, &end, 10);
+        } else if (*p == 'J') {
+            t->type = 'J';
+            t->day = strtol(p + 1, &end, 10);
+        } else {
+            t->type = 'D';
+            t->day = strtol(p, &end, 10);
+        }
+        p = end;
+        t->time = 7200;
+        if (*p == '/' && !(p = parseTime(p + 1, t->time))) {
+            return false;
+        }
+    }
+    return *p == '\0';
+}
+
+// UTC time of a transition in the given year, offset is the one in effect before the transition
+time_t TimeZoneRule::transitionTime(const Transition &t, int year, long offset) {
+    long days;
+    if (t.type == 'M') {
+        long first = daysFromCivil(year, t.month, 1);
+        int firstWeekday = (first % 7 + 11) % 7; // 1970-01-01 was a Thursday
+        int mday = 1 + (t.day - firstWeekday + 7) % 7 + (t.week - 1) * 7;
+        if (mday > daysInMonth(year, t.month)) {
+            mday -= 7;
+        }
+        days = first + mday - 1;
+    } else if (t.type == 'J') {
+        days = daysFromCivil(year, 1, 1) + t.day - 1 + (isLeapYear(year) && t.day >= 60);
+    } else {
+        days = daysFromCivil(year, 1, 1) + t.day;
+    }
+    return (time_t) days * 86400 + t.time - offset;
+}
+
+int TimeZoneRule::getOffset(time_t utc, time_t &nextChange) {
+    nextChange = 0;
+    if (!m_hasDst) {
+        return m_stdOffset;
+    }
+    int year = yearFromDays((utc + m_stdOffset) / 86400);
+    // Walk the transitions of last, this and next year in order, the last one passed decides the offset
+    bool dst = false;
+    for (int y = year - 1; y <= year + 1; y++) {
+        time_t start = transitionTime(m_dstStart, y, m_stdOffset);
+        time_t end = transitionTime(m_dstEnd, y, m_dstOffset);
+        time_t first = start < end ? start : end;
+        time_t second = start < end ? end : start;
+        if (utc < first) {
+            nextChange = first;
+            break;
+        }
+        dst = first == start;
+        if (utc < second) {
+            nextChange = second;
+            break;
+        }
+        dst = second == start;
+    }
+    return dst ? m_dstOffset : m_stdOffset;
+}
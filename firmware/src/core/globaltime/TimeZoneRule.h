@@ -0,0 +1,32 @@
+#ifndef TIMEZONERULE_H
+#define TIMEZONERULE_H
+
+#include <time.h>
+
+// Evaluates a POSIX TZ rule like "CET-1CEST,M3.5.0,M10.5.0/3" without any network access
+class TimeZoneRule {
+public:
+    bool setLocation(const char *location);
+    bool parse(const char *rule);
+    // Offset to UTC in seconds at the given UTC time, nextChange is set to the UTC time of the next DST transition (0 if none)
+    int getOffset(time_t utc, time_t &nextChange);
+
+private:
+    struct Transition {
+        char type = 'M'; // 'J' = Julian day without Feb 29, 'D' = zero based day with Feb 29, 'M' = month.week.weekday
+        int day = 0;
+        int week = 0;
+        int month = 0;
+        long time = 7200; // Local time of day in seconds
+    };
+
+    long m_stdOffset = 0;
+    long m_dstOffset = 0;
+    bool m_hasDst = false;
+    Transition m_dstStart;
+    Transition m_dstEnd;
+
+    time_t transitionTime(const Transition &t, int year, long offset);
+};
+
+#endif
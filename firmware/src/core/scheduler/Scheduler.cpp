@@ -0,0 +1,77 @@
+#include "Scheduler.h"
+
+#include <WiFi.h>
+#include <sdkconfig.h>
+#if CONFIG_PM_ENABLE && CONFIG_FREERTOS_USE_TICKLESS_IDLE
+    #include <esp_pm.h>
+#endif
+
+TaskHandle_t Scheduler::m_loopTask = nullptr;
+long Scheduler::m_sleep = LOOP_MAX_SLEEP;
+#ifdef BENCHMARK
+unsigned long Scheduler::m_statsStart = 0;
+unsigned long Scheduler::m_slept = 0;
+#endif
+
+void Scheduler::begin() {
+    m_loopTask = xTaskGetCurrentTaskHandle();
+    // Connection changes have to be handled right away
+    WiFi.onEvent([](arduino_event_id_t event, arduino_event_info_t info) {
+        wakeUp();
+    });
+#if CONFIG_PM_ENABLE && CONFIG_FREERTOS_USE_TICKLESS_IDLE
+    // Light sleep when idle, but no frequency scaling: TFT_eSPI drives the SPI registers
+    // directly and doesn't hold a PM lock, a lower APB clock would garble the transfers
+    esp_pm_config_esp32_t pm = {};
+    pm.max_freq_mhz = getCpuFrequencyMhz();
+    pm.min_freq_mhz = getCpuFrequencyMhz();
+    pm.light_sleep_enable = true;
+    if (esp_pm_configure(&pm) == ESP_OK) {
+        Serial.println("Light sleep enabled");
+    }
+#endif
+#ifdef BENCHMARK
+    m_statsStart = millis();
+#endif
+}
+
+void Scheduler::runWithin(long ms) {
+    if (ms < m_sleep) {
+        m_sleep = ms < 0 ? 0 : ms;
+    }
+}
+
+void Scheduler::sleep() {
+    if (m_sleep > 0 && m_loopTask != nullptr) {
+#ifdef BENCHMARK
+        unsigned long start = millis();
+#endif
+        // One more tick, pdMS_TO_TICKS rounds down and waking up early would need another pass
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(m_sleep) + 1);
+#ifdef BENCHMARK
+        m_slept += millis() - start;
+#endif
+    }
+    m_sleep = LOOP_MAX_SLEEP;
+#ifdef BENCHMARK
+    unsigned long elapsed = millis() - m_statsStart;
+    if (elapsed >= 60000) {
+        Serial.printf("Main loop slept %lu%% of the last %lu s\n", m_slept * 100 / elapsed, elapsed / 1000);
+        m_statsStart = millis();
+        m_slept = 0;
+    }
+#endif
+}
+
+void Scheduler::wakeUp() {
+    if (m_loopTask != nullptr) {
+        xTaskNotifyGive(m_loopTask);
+    }
+}
+
+// No yield, the loop task runs on the next tick at the latest
+void Scheduler::wakeUpFromISR() {
+    if (m_loopTask != nullptr) {
+        vTaskNotifyGiveFromISR(m_loopTask, nullptr);
+    }
+}
@@ -0,0 +1,36 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+
+// Longest time the main loop sleeps without any deadline
+#ifndef LOOP_MAX_SLEEP
+    #define LOOP_MAX_SLEEP 1000
+#endif
+
+// Lets the main loop sleep until its next deadline instead of spinning.
+// Every pass collects the deadlines of the clock and the current widget with runWithin(),
+// sleep() then blocks the loop task until the earliest one or until a button or WiFi event wakes it up.
+// While the loop sleeps only the idle task runs, so the CPU waits for interrupts
+// (and goes to light sleep if the SDK is built with power management and tickless idle).
+class Scheduler {
+public:
+    // Called from setup(), which runs in the loop task
+    static void begin();
+    // The loop has to run again within ms
+    static void runWithin(long ms);
+    // Sleep until the earliest deadline (or a wake up), then start collecting deadlines again
+    static void sleep();
+    static void wakeUp();
+    static void wakeUpFromISR();
+
+private:
+    static TaskHandle_t m_loopTask;
+    static long m_sleep;
+#ifdef BENCHMARK
+    static unsigned long m_statsStart;
+    static unsigned long m_slept;
+#endif
+};
+
+#endif // SCHEDULER_H
@@ -0,0 +1,178 @@
+#include "GlyphPack.h"
+#include <climits>
+
+#ifdef GLYPH_PACKS
+    // Generated by tools/glyphpack/gen_glyph_packs.sh
+    #include "GlyphPacks.h"
+#endif
+
+const GlyphPackData *GlyphPack::find(TTF_Font font, unsigned int fontSize) {
+#ifdef GLYPH_PACKS
+    for (int i = 0; i < PACKED_FONT_COUNT; i++) {
+        if (PACKED_FONTS[i].font == font && PACKED_FONTS[i].size == fontSize) {
+            return &PACKED_FONTS[i];
+        }
+    }
+#endif
+    return nullptr;
+}
+
+const PackedGlyph *GlyphPack::findGlyph(const GlyphPackData &pack, uint16_t codepoint) {
+    int lo = 0;
+    int hi = pack.glyphCount - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        if (pack.glyphs[mid].codepoint == codepoint) {
+            return &pack.glyphs[mid];
+        } else if (pack.glyphs[mid].codepoint < codepoint) {
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return nullptr;
+}
+
+// Draw a single line of text at the same position as OpenFontRender::drawString() (with align to ink enabled).
+// Returns false without drawing anything if the text has a line break or a character that is not in the pack.
+bool GlyphPack::draw(const GlyphPackData &pack, const char *text, int32_t x, int32_t y, Align align, uint16_t fg, uint16_t bg, const SpanFunc &drawSpan) {
+    // Measure the ink box of the line first
+    int32_t penX = x;
+    int32_t inkLeft = INT_MAX, inkRight = INT_MIN, inkTop = INT_MIN, inkBottom = INT_MAX;
+    int32_t bearing = 0;
+    bool first = true;
+    for (const char *p = text; *p;) {
+        const PackedGlyph *glyph = findGlyph(pack, decodeUTF8(p));
+        if (glyph == nullptr) {
+            return false;
+        }
+        if (first) {
+            bearing = glyph->bearing;
+            first = false;
+        }
+        inkLeft = min(inkLeft, penX + glyph->inkLeft);
+        inkRight = max(inkRight, penX + glyph->inkRight);
+        inkTop = max(inkTop, (int32_t) glyph->inkTop);
+        inkBottom = min(inkBottom, (int32_t) glyph->inkBottom);
+        penX += glyph->advance;
+    }
+    if (first) {
+        // Empty string
+        return true;
+    }
+
+    // Same alignment rules as OpenFontRender::drawHString()
+    int32_t width = inkRight - inkLeft;
+    int32_t height = inkTop - inkBottom;
+    int32_t offsetX = inkLeft - x - bearing;
+    int32_t offsetY = 0;
+    int32_t lineX = x;
+    int32_t lineY = y - pack.ascender + inkTop;
+    switch (align) {
+    case Align::Center:
+    case Align::TopCenter:
+    case Align::MiddleCenter:
+    case Align::BottomCenter:
+        offsetX += width / 2;
+        lineX -= bearing / 2;
+        break;
+    case Align::Right:
+    case Align::TopRight:
+    case Align::MiddleRight:
+    case Align::BottomRight:
+        offsetX += width;
+        lineX -= bearing;
+        break;
+    default:
+        break;
+    }
+    switch (align) {
+    case Align::MiddleLeft:
+    case Align::MiddleCenter:
+    case Align::MiddleRight:
+        offsetY = height / 2;
+        break;
+    case Align::BottomLeft:
+    case Align::BottomCenter:
+    case Align::BottomRight:
+        offsetY = height;
+        break;
+    default:
+        break;
+    }
+
+    uint16_t blend[16];
+    for (int level = 0; level < 16; level++) {
+        blend[level] = alphaBlend(level * 17, fg, bg);
+    }
+
+    // Push every run of visible pixels of a glyph row at once
+    static uint16_t line[256];
+    penX = lineX - offsetX;
+    int32_t baseline = lineY - offsetY + pack.ascender;
+    for (const char *p = text; *p;) {
+        const PackedGlyph *glyph = findGlyph(pack, decodeUTF8(p));
+        const uint8_t *data = pack.bitmaps + glyph->offset;
+        int32_t glyphX = penX + glyph->left;
+        int32_t glyphY = baseline - glyph->top;
+        for (int32_t gy = 0; gy < glyph->height; gy++) {
+            int32_t gx = 0;
+            int32_t runStart = -1;
+            while (gx < glyph->width) {
+                uint8_t level = *data >> 4;
+                int32_t count = (*data++ & 0x0F) + 1;
+                if (level) {
+                    uint16_t color = level == 0x0F ? fg : blend[level];
+                    if (runStart < 0) {
+                        runStart = gx;
+                    }
+                    for (int32_t i = 0; i < count; i++) {
+                        line[gx + i] = color;
+                    }
+                } else if (runStart >= 0) {
+                    drawSpan(glyphX + runStart, glyphY + gy, gx - runStart, line + runStart);
+                    runStart = -1;
+                }
+                gx += count;
+            }
+            if (runStart >= 0) {
+                drawSpan(glyphX + runStart, glyphY + gy, gx - runStart, line + runStart);
+            }
+        }
+        penX += glyph->advance;
+    }
+    return true;
+}
+
+uint16_t GlyphPack::decodeUTF8(const char *&str) {
+    uint8_t c = *str++;
+    if ((c & 0x80) == 0x00) {
+        return c;
+    }
+    if ((c & 0xE0) == 0xC0 && str[0]) {
+        return ((c & 0x1F) << 6) | (*str++ & 0x3F);
+    }
+    if ((c & 0xF0) == 0xE0 && str[0] && str[1]) {
+        uint16_t u = ((c & 0x0F) << 12) | ((*str++ & 0x3F) << 6);
+        return u | (*str++ & 0x3F);
+    }
+    // Not supported, will not be found in the pack
+    return c;
+}
+
+// Same fixed point blend as OpenFontRender, so packed and rendered text look the same
+uint16_t GlyphPack::alphaBlend(uint8_t alpha, uint16_t fgc, uint16_t bgc) {
+    uint16_t fgR = ((fgc >> 10) & 0x3E) + 1;
+    uint16_t fgG = ((fgc >> 4) & 0x7E) + 1;
+    uint16_t fgB = ((fgc << 1) & 0x3E) + 1;
+
+    uint16_t bgR = ((bgc >> 10) & 0x3E) + 1;
+    uint16_t bgG = ((bgc >> 4) & 0x7E) + 1;
+    uint16_t bgB = ((bgc << 1) & 0x3E) + 1;
+
+    uint16_t r = (((fgR * alpha) + (bgR * (255 - alpha))) >> 9);
+    uint16_t g = (((fgG * alpha) + (bgG * (255 - alpha))) >> 9);
+    uint16_t b = (((fgB * alpha) + (bgB * (255 - alpha))) >> 9);
+
+    return (r << 11) | (g << 5) | (b << 0);
+}
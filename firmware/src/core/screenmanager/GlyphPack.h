@@ -0,0 +1,49 @@
+#ifndef GLYPHPACK_H
+#define GLYPHPACK_H
+
+#include "ttf-fonts.h"
+#include <OpenFontRender.h>
+#include <functional>
+
+// A pre-rasterized glyph. The bitmap is 4 bit alpha, run length encoded per row:
+// every byte is a run of ((byte & 0x0F) + 1) pixels with alpha level (byte >> 4).
+struct PackedGlyph {
+    uint16_t codepoint;
+    uint8_t width;
+    uint8_t height;
+    int16_t left; // Bitmap position relative to the pen/baseline
+    int16_t top;
+    int16_t inkLeft; // Grid fitted outline box, used for alignment like OpenFontRender does
+    int16_t inkRight;
+    int16_t inkTop;
+    int16_t inkBottom;
+    int16_t bearing;
+    int16_t advance;
+    uint32_t offset; // Into GlyphPackData::bitmaps
+};
+
+// All pre-rasterized glyphs of one font at one (scaled) pixel size, generated by tools/glyphpack
+struct GlyphPackData {
+    TTF_Font font;
+    uint16_t size;
+    int16_t ascender;
+    uint16_t glyphCount;
+    const PackedGlyph *glyphs; // Sorted by codepoint
+    const uint8_t *bitmaps;
+};
+
+// Draws text from glyph packs without going through FreeType
+class GlyphPack {
+public:
+    using SpanFunc = std::function<void(int32_t x, int32_t y, int32_t w, uint16_t *colors)>;
+
+    static const GlyphPackData *find(TTF_Font font, unsigned int fontSize);
+    static bool draw(const GlyphPackData &pack, const char *text, int32_t x, int32_t y, Align align, uint16_t fg, uint16_t bg, const SpanFunc &drawSpan);
+
+private:
+    static const PackedGlyph *findGlyph(const GlyphPackData &pack, uint16_t codepoint);
+    static uint16_t decodeUTF8(const char *&str);
+    static uint16_t alphaBlend(uint8_t alpha, uint16_t fgc, uint16_t bgc);
+};
+
+#endif
@@ -0,0 +1,148 @@
+#include "PackedImage.h"
+
+// File layout (little endian):
+//   header:  "PIMG", version (1 byte), variant count (1 byte), 2 reserved bytes
+//   variant: scale (1 byte), reserved (1 byte), width (2 bytes), height (2 bytes), 2 reserved bytes, offset of the codes (4 bytes)
+//   codes of every variant up to the next variant (or the end of the file)
+#define PACKED_IMAGE_VERSION 1
+#define PACKED_IMAGE_HEADER_SIZE 8
+#define PACKED_IMAGE_VARIANT_SIZE 12
+
+// Codes, the previous pixel starts as black
+#define PACKED_OP_INDEX 0x00 // 00iiiiii: pixel from the index of recently seen pixels
+#define PACKED_OP_DIFF 0x40  // 01rrggbb: small difference to the previous pixel (-2..1 per channel)
+#define PACKED_OP_LUMA 0x80  // 10gggggg rrrrbbbb: green difference (-32..31), red and blue relative to it (-8..7)
+#define PACKED_OP_RUN 0xC0   // 11nnnnnn: repeat the previous pixel n + 1 times (1..62)
+#define PACKED_OP_RAW 0xFE   // followed by the RGB565 pixel
+#define PACKED_OP_MASK 0xC0
+
+static uint16_t read16(const byte *p) {
+    return p[0] | (p[1] << 8);
+}
+
+static uint32_t read32(const byte *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+static uint8_t hashPixel(uint16_t pixel) {
+    return (uint16_t) (pixel * 0x9E37u) >> 10;
+}
+
+bool PackedImage::isPacked(const byte *data, size_t size) {
+    return size >= PACKED_IMAGE_HEADER_SIZE && memcmp(data, "PIMG", 4) == 0 && data[4] == PACKED_IMAGE_VERSION;
+}
+
+bool PackedImage::findVariant(const byte *data, size_t size, int scale, Variant &variant) {
+    if (!isPacked(data, size)) {
+        return false;
+    }
+    int count = data[5];
+    if (size < PACKED_IMAGE_HEADER_SIZE + count * PACKED_IMAGE_VARIANT_SIZE) {
+        return false;
+    }
+    for (int i = 0; i < count; i++) {
+        const byte *entry = data + PACKED_IMAGE_HEADER_SIZE + i * PACKED_IMAGE_VARIANT_SIZE;
+        if (entry[0] != scale) {
+            continue;
+        }
+        uint32_t offset = read32(entry + 8);
+        uint32_t end = i + 1 < count ? read32(entry + PACKED_IMAGE_VARIANT_SIZE + 8) : size;
+        if (offset > end || end > size) {
+            return false;
+        }
+        variant.width = read16(entry + 2);
+        variant.height = read16(entry + 4);
+        variant.codes = data + offset;
+        variant.end = data + end;
+        return true;
+    }
+    return false;
+}
+
+bool PackedImage::getSize(const byte *data, size_t size, int scale, uint16_t *w, uint16_t *h) {
+    Variant variant;
+    if (!findVariant(data, size, scale, variant)) {
+        return false;
+    }
+    *w = variant.width;
+    *h = variant.height;
+    return true;
+}
+
+// Decode the variant for the given scale and pass it on in blocks of whole rows.
+// Returns false if there is no such variant.
+bool PackedImage::draw(int32_t x, int32_t y, const byte *data, size_t size, int scale, const BlockFunc &output) {
+    Variant variant;
+    if (!findVariant(data, size, scale, variant) || variant.width == 0 || variant.width > PACKED_IMAGE_BLOCK_PIXELS) {
+        return false;
+    }
+
+    static uint16_t block[PACKED_IMAGE_BLOCK_PIXELS];
+    uint16_t index[64] = {0};
+    uint16_t pixel = 0;
+    int run = 0;
+    const byte *p = variant.codes;
+    int rowsPerBlock = PACKED_IMAGE_BLOCK_PIXELS / variant.width;
+
+    for (int row = 0; row < variant.height; row += rowsPerBlock) {
+        int rows = min(rowsPerBlock, variant.height - row);
+        uint16_t *out = block;
+        uint16_t *blockEnd = block + rows * variant.width;
+        while (out < blockEnd) {
+            if (run > 0) {
+                // Fill as much of the run as fits into the block
+                int n = min(run, (int) (blockEnd - out));
+                uint16_t swapped = (pixel >> 8) | (pixel << 8);
+                for (int i = 0; i < n; i++) {
+                    out[i] = swapped;
+                }
+                out += n;
+                run -= n;
+                continue;
+            }
+            if (p >= variant.end) {
+                // Truncated, keep the last pixel
+                run = blockEnd - out;
+                continue;
+            }
+            uint8_t code = *p++;
+            if (code == PACKED_OP_RAW) {
+                pixel = read16(p);
+                p += 2;
+            } else {
+                uint8_t r = pixel >> 11;
+                uint8_t g = (pixel >> 5) & 0x3F;
+                uint8_t b = pixel & 0x1F;
+                switch (code & PACKED_OP_MASK) {
+                case PACKED_OP_INDEX:
+                    pixel = index[code];
+                    break;
+                case PACKED_OP_DIFF:
+                    r += ((code >> 4) & 0x03) - 2;
+                    g += ((code >> 2) & 0x03) - 2;
+                    b += (code & 0x03) - 2;
+                    pixel = ((r & 0x1F) << 11) | ((g & 0x3F) << 5) | (b & 0x1F);
+                    break;
+                case PACKED_OP_LUMA: {
+                    int dg = (code & 0x3F) - 32;
+                    uint8_t rb = *p++;
+                    r += dg + (rb >> 4) - 8;
+                    g += dg;
+                    b += dg + (rb & 0x0F) - 8;
+                    pixel = ((r & 0x1F) << 11) | ((g & 0x3F) << 5) | (b & 0x1F);
+                    break;
+                }
+                default:
+                    run = (code & 0x3F) + 1;
+                    continue;
+                }
+            }
+            index[hashPixel(pixel)] = pixel;
+            *out++ = (pixel >> 8) | (pixel << 8);
+        }
+        if (!output(x, y + row, variant.width, rows, block)) {
+            break;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,36 @@
+#ifndef PACKEDIMAGE_H
+#define PACKEDIMAGE_H
+
+#include <Arduino.h>
+#include <functional>
+
+// Number of pixels decoded before they are passed on (whole rows, must be at least the image width)
+#ifndef PACKED_IMAGE_BLOCK_PIXELS
+    #define PACKED_IMAGE_BLOCK_PIXELS 2048
+#endif
+
+// Pre-decoded RGB565 images, generated from the JPEGs in images/ by tools/pack_images.py.
+// An image holds one variant per pre-computed scale (1 = full size, 2, 4, 8 like TJpgDec),
+// every variant is compressed with QOI style run, index and difference codes (see tools/pack_images.py).
+class PackedImage {
+public:
+    // Receives a block of rows, the pixels are byte swapped (like TJpgDec with setSwapBytes(true)).
+    // Return false to stop decoding.
+    using BlockFunc = std::function<bool(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t *pixels)>;
+
+    static bool isPacked(const byte *data, size_t size);
+    static bool getSize(const byte *data, size_t size, int scale, uint16_t *w, uint16_t *h);
+    static bool draw(int32_t x, int32_t y, const byte *data, size_t size, int scale, const BlockFunc &output);
+
+private:
+    struct Variant {
+        uint16_t width;
+        uint16_t height;
+        const byte *codes;
+        const byte *end;
+    };
+
+    static bool findVariant(const byte *data, size_t size, int scale, Variant &variant);
+};
+
+#endif
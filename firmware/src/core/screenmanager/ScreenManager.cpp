@@ -1,6 +1,11 @@
 #include "ScreenManager.h"
 #include "Utils.h"
 #include <Arduino.h>
+#include <TJpg_Decoder.h>
+
+#ifdef ESP32
+    #include <soc/gpio_struct.h>
+#endif
 
 ScreenManager::ScreenManager(TFT_eSPI &tft) : m_tft(tft) {
 
@@ -8,6 +13,7 @@ ScreenManager::ScreenManager(TFT_eSPI &tft) : m_tft(tft) {
         pinMode(m_screen_cs[i], OUTPUT);
         digitalWrite(m_screen_cs[i], LOW);
     }
+    m_selectedScreens = ALL_SCREENS;
 
     m_tft.init();
     m_tft.setRotation(INVERTED_ORBS ? 2 : 0);
@@ -15,11 +21,23 @@ ScreenManager::ScreenManager(TFT_eSPI &tft) : m_tft(tft) {
     m_tft.setTextDatum(MC_DATUM);
     reset();
 
-    // I'm not sure which cache size is actually good.
-    // Needs testing.
-    m_render.setCacheSize(128, 128, 8192);
+    // All fonts share the cache, so limit the number of font sizes (FreeType size objects) kept around.
+    // The byte budget starts small and grows while glyphs get evicted, see tuneGlyphCache()
+    m_render.setCacheSize(8, 32, GLYPH_CACHE_MIN_BYTES);
     setFont(DEFAULT_FONT);
-    m_render.setDrawer(m_tft);
+    // Correct misaligned Y while drawing instead of measuring every string first
+    // See https://github.com/takkaO/OpenFontRender/issues/38
+    m_render.setAlignToInk(true);
+    // Route TTF rendering through forEachTarget() so it also works off-screen
+    m_render.set_drawPixel([this](int32_t x, int32_t y, uint16_t c) {
+        forEachTarget([&](TFT_eSPI &target) { target.drawPixel(x, y, c); });
+    });
+    m_render.set_drawFastHLine([this](int32_t x, int32_t y, int32_t w, uint16_t c) {
+        forEachTarget([&](TFT_eSPI &target) { target.drawFastHLine(x, y, w, c); });
+    });
+    m_render.set_drawHSpan([this](int32_t x, int32_t y, int32_t w, uint16_t *colors) { drawSpan(x, y, w, colors); });
+    m_render.set_startWrite([this]() { startWrite(); });
+    m_render.set_endWrite([this]() { endWrite(); });
 
     Serial.println("ScreenManager initialized");
     Serial.println("TFT_MOSI:" + String(TFT_MOSI));
@@ -40,40 +58,260 @@ void ScreenManager::setFont(TTF_Font font) {
         // nothing to do
         return;
     }
-    m_render.unloadFont();
-    // Font is now unloaded
-    m_curFont = TTF_Font::NONE;
+    collectGlyphCacheStats();
     if (font == TTF_Font::NONE) {
-        // just unload
+        // Unload all fonts, this drops the glyph cache
+        m_render.unloadFont();
+        m_curFont = TTF_Font::NONE;
         return;
     }
+    // Switching fonts keeps the glyphs of the other fonts in the cache
     // 0 is success
     FT_Error error = 1;
     switch (font) {
     case ROBOTO_REGULAR:
-        error = m_render.loadFont(robotoRegular_start, robotoRegular_end - robotoRegular_start);
+        error = m_render.loadFont(robotoRegular_start(), robotoRegular_end() - robotoRegular_start());
         break;
 
     case FINAL_FRONTIER:
-        error = m_render.loadFont(finalFrontier_start, finalFrontier_end - finalFrontier_start);
+        error = m_render.loadFont(finalFrontier_start(), finalFrontier_end() - finalFrontier_start());
         break;
 
     case DSEG7:
-        error = m_render.loadFont(dseg7_start, dseg7_end - dseg7_start);
+        error = m_render.loadFont(dseg7_start(), dseg7_end() - dseg7_start());
         break;
 
     case DSEG14:
-        error = m_render.loadFont(dseg14_start, dseg14_end - dseg14_start);
+        error = m_render.loadFont(dseg14_start(), dseg14_end() - dseg14_start());
         break;
     }
     if (error == 0) {
         m_curFont = font;
     } else {
+        m_curFont = TTF_Font::NONE;
         Serial.printf("Unable to load TTF font %d\n", font);
     }
 }
 
+// Push a horizontal run of RGB565 pixels (from TTF rendering)
+void ScreenManager::drawSpan(int32_t x, int32_t y, int32_t w, uint16_t *colors) {
+    // pushImage() expects byte swapped pixels (like the JPEG decoder output)
+    for (int32_t i = 0; i < w; i++) {
+        colors[i] = (colors[i] >> 8) | (colors[i] << 8);
+    }
+    forEachTarget([&](TFT_eSPI &target) { target.pushImage(x, y, w, 1, colors); });
+}
+
+void ScreenManager::startWrite() {
+    if (!m_offscreenActive) {
+        m_tft.startWrite();
+    }
+}
+
+void ScreenManager::endWrite() {
+    if (!m_offscreenActive) {
+        m_tft.endWrite();
+    }
+}
+
+static const char *fontName(TTF_Font font) {
+    switch (font) {
+    case ROBOTO_REGULAR:
+        return "Roboto";
+    case FINAL_FRONTIER:
+        return "FinalFrontier";
+    case DSEG7:
+        return "DSEG7";
+    case DSEG14:
+        return "DSEG14";
+    default:
+        return "None";
+    }
+}
+
+// Move the glyph cache statistics of the current font from the renderer into m_glyphCacheUsage
+void ScreenManager::collectGlyphCacheStats() {
+    GlyphCacheStats stats[GLYPH_CACHE_STATS_SIZE];
+    int count = min(m_render.getCacheStats(stats, GLYPH_CACHE_STATS_SIZE), (unsigned int) GLYPH_CACHE_STATS_SIZE);
+    for (int i = 0; i < count; i++) {
+        GlyphCacheUsage *usage = nullptr;
+        for (int j = 0; j < m_glyphCacheUsageCount; j++) {
+            if (m_glyphCacheUsage[j].font == m_curFont && m_glyphCacheUsage[j].stats.font_size == stats[i].font_size) {
+                usage = &m_glyphCacheUsage[j];
+                break;
+            }
+        }
+        if (usage == nullptr) {
+            if (m_glyphCacheUsageCount == GLYPH_CACHE_STATS_SIZE) {
+                continue;
+            }
+            usage = &m_glyphCacheUsage[m_glyphCacheUsageCount++];
+            usage->font = m_curFont;
+            usage->stats = {stats[i].font_size, 0, 0, 0};
+        }
+        usage->stats.lookups += stats[i].lookups;
+        usage->stats.misses += stats[i].misses;
+        usage->stats.evictions += stats[i].evictions;
+    }
+    m_glyphCachePeak = max(m_glyphCachePeak, m_render.getCachePeakBytes());
+    m_render.resetCacheStats();
+}
+
+// Report the glyph cache statistics and adapt the byte budget every GLYPH_CACHE_TUNE_INTERVAL:
+// grow it (up to GLYPH_CACHE_MAX_BYTES and while enough heap is left) if glyphs had to be evicted,
+// shrink it towards the observed working set if less than half of it was used.
+void ScreenManager::tuneGlyphCache() {
+    if (millis() - m_glyphCacheTuned < GLYPH_CACHE_TUNE_INTERVAL) {
+        return;
+    }
+    m_glyphCacheTuned = millis();
+    collectGlyphCacheStats();
+
+    uint32_t lookups = 0, misses = 0, evictions = 0;
+    for (int i = 0; i < m_glyphCacheUsageCount; i++) {
+        lookups += m_glyphCacheUsage[i].stats.lookups;
+        misses += m_glyphCacheUsage[i].stats.misses;
+        evictions += m_glyphCacheUsage[i].stats.evictions;
+    }
+    if (lookups == 0) {
+        // Nothing drawn, nothing learned
+        return;
+    }
+
+    unsigned long budget = m_render.getCacheMaxBytes();
+    unsigned long newBudget = budget;
+    uint32_t freeHeap = ESP.getFreeHeap();
+    if (evictions > 0) {
+        newBudget = grownGlyphCacheBudget();
+    } else if (m_glyphCachePeak < budget / 2) {
+        newBudget = max(m_glyphCachePeak + m_glyphCachePeak / 2, (unsigned long) GLYPH_CACHE_MIN_BYTES);
+    }
+
+    Serial.printf("Glyph cache: %u lookups, %u%% hits, %u evictions, peak %lu of %lu bytes, %u bytes heap free\n",
+                  lookups, (lookups - misses) * 100 / lookups, evictions, m_glyphCachePeak, budget, freeHeap);
+    for (int i = 0; i < m_glyphCacheUsageCount; i++) {
+        const GlyphCacheStats &stats = m_glyphCacheUsage[i].stats;
+        if (stats.lookups > 0) {
+            Serial.printf("  %s %upx: %u lookups, %u%% hits, %u evictions\n", fontName(m_glyphCacheUsage[i].font), stats.font_size,
+                          stats.lookups, (stats.lookups - stats.misses) * 100 / stats.lookups, stats.evictions);
+        }
+    }
+    if (newBudget != budget) {
+        Serial.printf("Glyph cache budget changed from %lu to %lu bytes\n", budget, newBudget);
+        m_render.setCacheMaxBytes(newBudget);
+    }
+
+    m_glyphCacheUsageCount = 0;
+    m_glyphCachePeak = 0;
+}
+
+// Double the glyph cache budget, up to GLYPH_CACHE_MAX_BYTES and as long as GLYPH_CACHE_HEAP_RESERVE bytes of heap stay free
+unsigned long ScreenManager::grownGlyphCacheBudget() {
+    unsigned long budget = m_render.getCacheMaxBytes();
+    unsigned long newBudget = max(budget, min(budget * 2, (unsigned long) GLYPH_CACHE_MAX_BYTES));
+    uint32_t freeHeap = ESP.getFreeHeap();
+    if (freeHeap < GLYPH_CACHE_HEAP_RESERVE + (newBudget - budget)) {
+        newBudget = budget + (freeHeap > GLYPH_CACHE_HEAP_RESERVE ? freeHeap - GLYPH_CACHE_HEAP_RESERVE : 0);
+    }
+    return newBudget;
+}
+
+void ScreenManager::registerGlyphs(TTF_Font font, unsigned int fontSize, const char *chars, bool applyScale) {
+    if (m_prewarmDone) {
+        return;
+    }
+    if (applyScale) {
+        fontSize = getScaledFontSize(fontSize);
+    }
+    // Keep the sets sorted by size, so the small (cheap) glyphs are cached first
+    auto it = m_glyphSets.begin();
+    while (it != m_glyphSets.end() && it->size <= fontSize) {
+        if (it->font == font && it->size == fontSize) {
+            it->chars += chars;
+            return;
+        }
+        it++;
+    }
+    m_glyphSets.insert(it, {font, fontSize, String(chars)});
+}
+
+// Rasterize the registered glyphs into the glyph cache one at a time (call while waiting, e.g. for WiFi), so the first
+// frame of every widget is served from the cache. Grows the cache budget like tuneGlyphCache() and stops before
+// glyphs would evict already cached ones.
+bool ScreenManager::prewarmGlyphCache() {
+    if (m_prewarmSet >= m_glyphSets.size()) {
+        m_prewarmDone = true;
+        return false;
+    }
+    if (m_prewarmSet == 0 && m_prewarmPos == 0) {
+        m_prewarmTime = millis();
+    }
+    const GlyphSet &set = m_glyphSets[m_prewarmSet];
+    bool done = false;
+    if (GlyphPack::find(set.font, set.size) != nullptr) {
+        // Drawn without FreeType
+        m_prewarmPos = set.chars.length();
+    } else {
+        // The bitmap and outline of a glyph take up to about size * size bytes
+        while (set.size * set.size + m_render.getCacheUsedBytes() > m_render.getCacheMaxBytes() && !done) {
+            unsigned long budget = grownGlyphCacheBudget();
+            if (budget > m_render.getCacheMaxBytes()) {
+                m_render.setCacheMaxBytes(budget);
+            } else {
+                Serial.printf("Glyph cache full, not prewarming %s %upx and larger\n", fontName(set.font), set.size);
+                done = true;
+            }
+        }
+        if (!done) {
+            TTF_Font prevFont = m_curFont;
+            unsigned int prevSize = m_render.getFontSize();
+            setFont(set.font);
+            m_render.setFontSize(set.size);
+            // Next UTF-8 character
+            char glyph[5];
+            int len = 0;
+            do {
+                glyph[len++] = set.chars[m_prewarmPos++];
+            } while (len < 4 && m_prewarmPos < set.chars.length() && (set.chars[m_prewarmPos] & 0xC0) == 0x80);
+            glyph[len] = '\0';
+            if (!m_render.preloadGlyphs(glyph)) {
+                // Something was evicted, the estimate above was too low
+                m_render.setCacheMaxBytes(max(m_render.getCacheMaxBytes(), grownGlyphCacheBudget()));
+            }
+            if (prevFont != TTF_Font::NONE) {
+                setFont(prevFont);
+            }
+            m_render.setFontSize(prevSize);
+        }
+    }
+    if (m_prewarmPos >= set.chars.length()) {
+        m_prewarmSet++;
+        m_prewarmPos = 0;
+    }
+    if (done || m_prewarmSet >= m_glyphSets.size()) {
+        Serial.printf("Glyph cache prewarmed in %lu ms, %lu of %lu bytes used\n", millis() - m_prewarmTime, m_render.getCacheUsedBytes(), m_render.getCacheMaxBytes());
+        // Only count real draws for the tuning
+        collectGlyphCacheStats();
+        m_glyphCacheUsageCount = 0;
+        m_glyphCachePeak = 0;
+        m_prewarmSet = 0;
+        m_glyphSets.clear();
+        m_glyphSets.shrink_to_fit();
+        m_prewarmDone = true;
+        return false;
+    }
+    return true;
+}
+
+// Returns the display or, while rendering off-screen, the buffer of the first selected screen
 TFT_eSPI &ScreenManager::getDisplay() {
+    if (m_offscreenActive) {
+        for (int i = 0; i < NUM_SCREENS; i++) {
+            if (m_selectedScreens & SCREEN_MASK(i)) {
+                return *m_offscreen[i];
+            }
+        }
+    }
     return m_tft;
 }
 
@@ -83,10 +321,64 @@ OpenFontRender &ScreenManager::getRender() {
 
 // Selects a single screen
 void ScreenManager::selectScreen(int screen) {
+    selectScreens(screen >= 0 && screen < NUM_SCREENS ? SCREEN_MASK(screen) : 0);
+}
+
+// Selects any combination of screens at once (bit i selects screen i).
+// Everything drawn afterwards is sent to all selected screens in the same SPI transfer.
+// Only CS pins that actually change are touched, and on the ESP32 they are
+// written directly to the GPIO set/clear registers instead of one digitalWrite() per pin.
+void ScreenManager::selectScreens(uint8_t screenMask) {
+    screenMask &= ALL_SCREENS;
+    uint8_t changed = screenMask ^ m_selectedScreens;
+    if (changed == 0) {
+        return;
+    }
+#ifdef ESP32
+    // CS is active low: selected screens are cleared, unselected ones are set
+    uint32_t clearLow = 0, setLow = 0, clearHigh = 0, setHigh = 0;
+    for (int i = 0; i < NUM_SCREENS; i++) {
+        if (!(changed & SCREEN_MASK(i))) {
+            continue;
+        }
+        uint8_t pin = getScreenPin(i);
+        bool select = screenMask & SCREEN_MASK(i);
+        if (pin < 32) {
+            (select ? clearLow : setLow) |= (1UL << pin);
+        } else {
+            (select ? clearHigh : setHigh) |= (1UL << (pin - 32));
+        }
+    }
+    // Deselect first so two different screen sets are never selected at the same time
+    if (setLow) {
+        GPIO.out_w1ts = setLow;
+    }
+    if (setHigh) {
+        GPIO.out1_w1ts.val = setHigh;
+    }
+    if (clearLow) {
+        GPIO.out_w1tc = clearLow;
+    }
+    if (clearHigh) {
+        GPIO.out1_w1tc.val = clearHigh;
+    }
+#else
     for (int i = 0; i < NUM_SCREENS; i++) {
-        int currentDisplay = INVERTED_ORBS ? NUM_SCREENS - i - 1 : i;
-        digitalWrite(m_screen_cs[currentDisplay], i == screen ? LOW : HIGH);
+        if (changed & SCREEN_MASK(i)) {
+            digitalWrite(getScreenPin(i), (screenMask & SCREEN_MASK(i)) ? LOW : HIGH);
+        }
     }
+#endif
+    m_selectedScreens = screenMask;
+}
+
+uint8_t ScreenManager::getSelectedScreens() {
+    return m_selectedScreens;
+}
+
+// Get the CS pin for a (logical) screen, taking INVERTED_ORBS into account
+uint8_t ScreenManager::getScreenPin(int screen) {
+    return m_screen_cs[INVERTED_ORBS ? NUM_SCREENS - screen - 1 : screen];
 }
 
 // Fills all screens with a color
@@ -110,11 +402,67 @@ void ScreenManager::clearScreen(int screen) {
 }
 
 void ScreenManager::fillScreen(uint32_t color) {
-    m_tft.fillScreen(dim(color));
+    forEachTarget([&](TFT_eSPI &target) { target.fillScreen(dim(color)); });
     // Set background for aliasing as well
     m_render.setBackgroundColor(dim(color));
 }
 
+// Allocate one full-screen buffer per screen.
+// This needs 5 * 240 * 240 * 2 bytes, so it's only possible with PSRAM.
+bool ScreenManager::initOffscreenBuffers() {
+    if (hasOffscreenBuffers()) {
+        return true;
+    }
+    if (!psramFound()) {
+        Serial.println("No PSRAM found, off-screen rendering disabled");
+        return false;
+    }
+    for (int i = 0; i < NUM_SCREENS; i++) {
+        m_offscreen[i] = new TFT_eSprite(&m_tft);
+        m_offscreen[i]->setColorDepth(16);
+        m_offscreen[i]->setAttribute(PSRAM_ENABLE, true);
+        if (m_offscreen[i]->createSprite(SCREEN_SIZE, SCREEN_SIZE) == nullptr) {
+            Serial.println("Unable to allocate off-screen buffers");
+            for (int j = 0; j <= i; j++) {
+                delete m_offscreen[j];
+                m_offscreen[j] = nullptr;
+            }
+            return false;
+        }
+    }
+    Serial.println("Off-screen buffers allocated");
+    return true;
+}
+
+bool ScreenManager::hasOffscreenBuffers() {
+    return m_offscreen[NUM_SCREENS - 1] != nullptr;
+}
+
+// All drawing until endOffscreen() goes to the buffers of the selected screens instead of the displays
+void ScreenManager::beginOffscreen() {
+    if (hasOffscreenBuffers()) {
+        reset();
+        m_offscreenActive = true;
+    }
+}
+
+void ScreenManager::endOffscreen() {
+    m_offscreenActive = false;
+    reset();
+}
+
+// Send the finished off-screen frames to the displays
+void ScreenManager::pushOffscreen() {
+    if (!hasOffscreenBuffers()) {
+        return;
+    }
+    for (int i = 0; i < NUM_SCREENS; i++) {
+        selectScreen(i);
+        m_offscreen[i]->pushSprite(0, 0);
+    }
+    reset();
+}
+
 bool ScreenManager::setBrightness(uint8_t brightness) {
     if (m_brightness != brightness) {
         Serial.printf("Brightness set to %d\n", brightness);
@@ -154,16 +502,12 @@ void ScreenManager::setFontSize(uint32_t size) {
 // I don't think that state should be used, It's kinda weird saying "ow select
 // all the screens to "off"
 void ScreenManager::selectAllScreens() {
-    for (int i = 0; i < NUM_SCREENS; i++) {
-        digitalWrite(m_screen_cs[i], LOW);
-    }
+    selectScreens(ALL_SCREENS);
 }
 
 // Unselect all screens
 void ScreenManager::reset() {
-    for (int i = 0; i < NUM_SCREENS; i++) {
-        digitalWrite(m_screen_cs[i], HIGH);
-    }
+    selectScreens(0);
 }
 
 unsigned int ScreenManager::calculateFitFontSize(uint32_t limit_width, uint32_t limit_height, Layout layout, const String &text) {
@@ -172,12 +516,36 @@ unsigned int ScreenManager::calculateFitFontSize(uint32_t limit_width, uint32_t
     return calcFontSize;
 }
 
-void ScreenManager::drawString(const String &text, int x, int y) {
+// Width of a single line of text in the current font, measurements are cached
+int ScreenManager::getTextWidth(const char *text, unsigned int fontSize, bool applyScale) {
+    if (applyScale) {
+        fontSize = getScaledFontSize(fontSize);
+    }
+    return m_textLayout.measure(m_curFont, fontSize, text);
+}
+
+// Wrap text (modified in place) by the real glyph widths of the current font, see TextLayout::wrap()
+int ScreenManager::wrapText(char *text, int maxWidth, unsigned int fontSize, const char *(&lines)[MAX_WRAPPED_LINES], int maxLines, bool applyScale) {
+    if (applyScale) {
+        fontSize = getScaledFontSize(fontSize);
+    }
+    return m_textLayout.wrap(m_curFont, fontSize, text, maxWidth, lines, maxLines);
+}
+
+void ScreenManager::drawString(const char *text, int x, int y) {
     // Use current font size and alignment
     drawString(text, x, y, 0, m_render.getAlignment());
 }
 
+void ScreenManager::drawString(const String &text, int x, int y) {
+    drawString(text.c_str(), x, y);
+}
+
 void ScreenManager::drawString(const String &text, int x, int y, unsigned int fontSize, Align align, int32_t fgColor, int32_t bgColor, bool applyScale) {
+    drawString(text.c_str(), x, y, fontSize, align, fgColor, bgColor, applyScale);
+}
+
+void ScreenManager::drawString(const char *text, int x, int y, unsigned int fontSize, Align align, int32_t fgColor, int32_t bgColor, bool applyScale) {
 
     if (fontSize == 0) {
         // Keep current font size
@@ -198,18 +566,30 @@ void ScreenManager::drawString(const String &text, int x, int y, unsigned int fo
         bgColor = dim(bgColor);
     }
 
-    // Dirty hack to correct misaligned Y
-    // See https://github.com/takkaO/OpenFontRender/issues/38
-    FT_BBox box = m_render.calculateBoundingBox(0, 0, fontSize, Align::TopLeft, Layout::Horizontal, text.c_str());
     m_render.setAlignment(align);
     m_render.setFontSize(fontSize);
-    m_render.drawString(text.c_str(), x, y - box.yMin, fgColor, bgColor);
+
+    // Use the pre-rasterized glyphs if there is a pack for this font and size (see GLYPH_PACKS)
+    const GlyphPackData *pack = GlyphPack::find(m_curFont, fontSize);
+    if (pack != nullptr) {
+        startWrite();
+        bool drawn = GlyphPack::draw(*pack, text, x, y, align, fgColor, bgColor, [this](int32_t sx, int32_t sy, int32_t w, uint16_t *colors) { drawSpan(sx, sy, w, colors); });
+        endWrite();
+        if (drawn) {
+            return;
+        }
+    }
+    m_render.drawString(text, x, y, fgColor, bgColor);
 }
 
-void ScreenManager::drawCentreString(const String &text, int x, int y, unsigned int fontSize) {
+void ScreenManager::drawCentreString(const char *text, int x, int y, unsigned int fontSize) {
     drawString(text, x, y, fontSize, Align::MiddleCenter);
 }
 
+void ScreenManager::drawCentreString(const String &text, int x, int y, unsigned int fontSize) {
+    drawCentreString(text.c_str(), x, y, fontSize);
+}
+
 void ScreenManager::drawFittedString(const String &text, int x, int y, int limit_w, int limit_h, Align align) {
     unsigned int fontSize = calculateFitFontSize(limit_w, limit_h, Layout::Horizontal, text);
     drawString(text, x, y, fontSize, align, -1, -1, false);
@@ -220,39 +600,78 @@ void ScreenManager::drawFittedString(const String &text, int x, int y, int limit
 }
 
 void ScreenManager::drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
-    m_tft.drawRect(x, y, w, h, dim(color));
+    forEachTarget([&](TFT_eSPI &target) { target.drawRect(x, y, w, h, dim(color)); });
 }
 
 void ScreenManager::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
-    m_tft.fillRect(x, y, w, h, dim(color));
+    forEachTarget([&](TFT_eSPI &target) { target.fillRect(x, y, w, h, dim(color)); });
 }
 
 void ScreenManager::drawLine(int32_t xs, int32_t ys, int32_t xe, int32_t ye, uint32_t color) {
-    m_tft.drawLine(xs, ys, xe, ye, dim(color));
+    forEachTarget([&](TFT_eSPI &target) { target.drawLine(xs, ys, xe, ye, dim(color)); });
 }
 
 void ScreenManager::drawArc(int32_t x, int32_t y, int32_t r, int32_t ir, uint32_t startAngle, uint32_t endAngle, uint32_t fg_color, uint32_t bg_color, bool smoothArc) {
-    m_tft.drawArc(x, y, r, ir, startAngle, endAngle, dim(fg_color), dim(bg_color), smoothArc);
+    forEachTarget([&](TFT_eSPI &target) { target.drawArc(x, y, r, ir, startAngle, endAngle, dim(fg_color), dim(bg_color), smoothArc); });
 }
 
 void ScreenManager::drawSmoothArc(int32_t x, int32_t y, int32_t r, int32_t ir, uint32_t startAngle, uint32_t endAngle, uint32_t fg_color, uint32_t bg_color, bool roundEnds) {
-    m_tft.drawSmoothArc(x, y, r, ir, startAngle, endAngle, dim(fg_color), dim(bg_color), roundEnds);
+    forEachTarget([&](TFT_eSPI &target) { target.drawSmoothArc(x, y, r, ir, startAngle, endAngle, dim(fg_color), dim(bg_color), roundEnds); });
 }
 
 void ScreenManager::drawTriangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, uint32_t color) {
-    m_tft.drawTriangle(x1, y1, x2, y2, x3, y3, dim(color));
+    forEachTarget([&](TFT_eSPI &target) { target.drawTriangle(x1, y1, x2, y2, x3, y3, dim(color)); });
 }
 
 void ScreenManager::fillTriangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, uint32_t color) {
-    m_tft.fillTriangle(x1, y1, x2, y2, x3, y3, dim(color));
+    forEachTarget([&](TFT_eSPI &target) { target.fillTriangle(x1, y1, x2, y2, x3, y3, dim(color)); });
 }
 
 void ScreenManager::drawCircle(int32_t x, int32_t y, int32_t r, uint32_t color) {
-    m_tft.drawCircle(x, y, r, dim(color));
+    forEachTarget([&](TFT_eSPI &target) { target.drawCircle(x, y, r, dim(color)); });
 }
 
 void ScreenManager::fillCircle(int32_t x, int32_t y, int32_t r, uint32_t color) {
-    m_tft.fillCircle(x, y, r, dim(color));
+    forEachTarget([&](TFT_eSPI &target) { target.fillCircle(x, y, r, dim(color)); });
+}
+
+void ScreenManager::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *data) {
+    forEachTarget([&](TFT_eSPI &target) { target.pushImage(x, y, w, h, data); });
+}
+
+void ScreenManager::drawImage(int32_t x, int32_t y, const byte *data, size_t size, int scale) {
+    if (data == nullptr || size == 0) {
+        // Missing asset (see AssetStore)
+        return;
+    }
+    if (!PackedImage::isPacked(data, size)) {
+        // JPEG, see tft_output() in main.cpp
+        TJpgDec.setJpgScale(scale);
+        TJpgDec.drawJpg(x, y, data, size);
+        return;
+    }
+    bool drawn = PackedImage::draw(x, y, data, size, scale, [&](int16_t bx, int16_t by, uint16_t w, uint16_t h, uint16_t *pixels) {
+        if (by >= ScreenHeight) {
+            return false;
+        }
+        if (m_brightness < 255) {
+            for (int i = 0; i < w * h; i++) {
+                pixels[i] = Utils::rgb565dim(pixels[i], m_brightness, true);
+            }
+        }
+        pushImage(bx, by, w, h, pixels);
+        return true;
+    });
+    if (!drawn) {
+        Serial.printf("drawImage: no variant for scale %d\n", scale);
+    }
+}
+
+void ScreenManager::drawImageFile(int32_t x, int32_t y, fs::FS &fs, const String &path, int scale) {
+    TJpgDec.setJpgScale(scale);
+    if (TJpgDec.drawFsJpg(x, y, path.c_str(), fs) != JDR_OK) {
+        Serial.printf("drawImageFile: cannot draw %s\n", path.c_str());
+    }
 }
 
 unsigned int ScreenManager::getScaledFontSize(unsigned int fontSize) {
@@ -270,37 +689,39 @@ uint16_t ScreenManager::dim(uint16_t color) {
 }
 
 int16_t ScreenManager::getLegacyFontHeight() {
-    return m_tft.fontHeight();
+    return getDisplay().fontHeight();
 }
 
 void ScreenManager::setLegacyTextColor(uint16_t color) {
-    m_tft.setTextColor(dim(color));
+    forEachTarget([&](TFT_eSPI &target) { target.setTextColor(dim(color)); });
 }
 
 void ScreenManager::setLegacyTextColor(uint16_t fgcolor, uint16_t bgcolor, bool bgfill) {
-    m_tft.setTextColor(dim(fgcolor), dim(bgcolor), bgfill);
+    forEachTarget([&](TFT_eSPI &target) { target.setTextColor(dim(fgcolor), dim(bgcolor), bgfill); });
 }
 
 void ScreenManager::setLegacyTextDatum(uint8_t datum) {
-    m_tft.setTextDatum(datum);
+    forEachTarget([&](TFT_eSPI &target) { target.setTextDatum(datum); });
 }
 
 void ScreenManager::setLegacyTextSize(uint8_t size) {
-    m_tft.setTextSize(size);
+    forEachTarget([&](TFT_eSPI &target) { target.setTextSize(size); });
 }
 
 void ScreenManager::setLegacyTextFont(uint8_t font) {
-    m_tft.setTextFont(font);
+    forEachTarget([&](TFT_eSPI &target) { target.setTextFont(font); });
 }
 
 void ScreenManager::drawLegacyString(const String &string, int32_t x, int32_t y) {
-    m_tft.drawString(string, x, y);
+    forEachTarget([&](TFT_eSPI &target) { target.drawString(string, x, y); });
 }
 
 void ScreenManager::drawLegacyString(const String &string, int32_t x, int32_t y, uint8_t font) {
-    m_tft.drawString(string, x, y, font);
+    forEachTarget([&](TFT_eSPI &target) { target.drawString(string, x, y, font); });
 }
 
 int16_t ScreenManager::drawLegacyChar(uint16_t uniCode, int32_t x, int32_t y, uint8_t font) {
-    return m_tft.drawChar(uniCode, x, y, font);
+    int16_t width = 0;
+    forEachTarget([&](TFT_eSPI &target) { width = target.drawChar(uniCode, x, y, font); });
+    return width;
 }
@@ -2,13 +2,22 @@
 #define SCREENMANAGER_H
 
 // Include any necessary libraries here
+#include "GlyphPack.h"
+#include "PackedImage.h"
+#include "TextLayout.h"
 #include "config_helper.h"
 #include "ttf-fonts.h"
+#include <FS.h>
 #include <OpenFontRender.h>
 #include <SPI.h>
 #include <TFT_eSPI.h>
+#include <vector>
 
 #define NUM_SCREENS 5
+#define ALL_SCREENS ((1 << NUM_SCREENS) - 1)
+
+// Bitmask for a single screen, use with selectScreens()
+#define SCREEN_MASK(screen) (1 << (screen))
 
 #ifndef DEFAULT_FONT
     #define DEFAULT_FONT ROBOTO_REGULAR
@@ -18,12 +27,31 @@
     #define TFT_BRIGHTNESS 255
 #endif
 
+// The glyph cache budget is tuned between these limits from the observed evictions (see tuneGlyphCache())
+#ifndef GLYPH_CACHE_MIN_BYTES
+    #define GLYPH_CACHE_MIN_BYTES 8192
+#endif
+#ifndef GLYPH_CACHE_MAX_BYTES
+    #define GLYPH_CACHE_MAX_BYTES 65536
+#endif
+// Don't grow the glyph cache if less free heap than this would be left
+#ifndef GLYPH_CACHE_HEAP_RESERVE
+    #define GLYPH_CACHE_HEAP_RESERVE 49152
+#endif
+#ifndef GLYPH_CACHE_TUNE_INTERVAL
+    #define GLYPH_CACHE_TUNE_INTERVAL 60000
+#endif
+// Number of (font, size) combinations tracked for the statistics
+#define GLYPH_CACHE_STATS_SIZE 16
+
 class ScreenManager {
 public:
     ScreenManager(TFT_eSPI &tft);
 
     void selectScreen(int screen);
+    void selectScreens(uint8_t screenMask);
     void selectAllScreens();
+    uint8_t getSelectedScreens();
     void reset();
 
     void fillAllScreens(uint32_t color);
@@ -31,6 +59,13 @@ public:
     void fillScreen(uint32_t color);
     void clearScreen(int screen = -1);
 
+    // Off-screen rendering into one buffer per screen (needs PSRAM)
+    bool initOffscreenBuffers();
+    bool hasOffscreenBuffers();
+    void beginOffscreen();
+    void endOffscreen();
+    void pushOffscreen();
+
     bool setBrightness(uint8_t brightness);
     uint8_t getBrightness();
 
@@ -42,14 +77,27 @@ public:
     void setFontSize(uint32_t size);
     void setAlignment(Align align);
 
+    // Glyph cache statistics and budget tuning, call regularly
+    void tuneGlyphCache();
+    // Register characters a widget draws at a font size, so they can be rasterized before the first frame.
+    // Ignored once the prewarm is done, widgets call this from setup() on every switch.
+    void registerGlyphs(TTF_Font font, unsigned int fontSize, const char *chars, bool applyScale = true);
+    // Rasterize the next registered glyph into the glyph cache, returns false when done
+    bool prewarmGlyphCache();
+
     // Helper functions
     unsigned int calculateFitFontSize(uint32_t limit_width, uint32_t limit_height, Layout layout, const String &text);
+    int getTextWidth(const char *text, unsigned int fontSize, bool applyScale = true);
+    int wrapText(char *text, int maxWidth, unsigned int fontSize, const char *(&lines)[MAX_WRAPPED_LINES], int maxLines = MAX_WRAPPED_LINES, bool applyScale = true);
 
     // Draw string functions
+    void drawString(const char *text, int x, int y, unsigned int fontSize, Align align, int32_t fgColor = -1, int32_t bgColor = -1, bool applyScale = true);
     void drawString(const String &text, int x, int y, unsigned int fontSize, Align align, int32_t fgColor = -1, int32_t bgColor = -1, bool applyScale = true);
+    void drawString(const char *text, int x, int y);
     void drawString(const String &text, int x, int y);
 
     // Draw centered string
+    void drawCentreString(const char *text, int x, int y, unsigned int fontSize = 0);
     void drawCentreString(const String &text, int x, int y, unsigned int fontSize = 0);
 
     // Draw string with a max width/height (auto-sizing)
@@ -67,6 +115,14 @@ public:
     void drawCircle(int32_t x, int32_t y, int32_t r, uint32_t color);
     void fillCircle(int32_t x, int32_t y, int32_t r, uint32_t color);
 
+    // Push already dimmed/converted RGB565 pixels (used by the JPEG decoder)
+    void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *data);
+
+    // Draw an embedded image, packed by tools/pack_images.py or JPEG (scale 1, 2, 4 or 8 = 1/scale size)
+    void drawImage(int32_t x, int32_t y, const byte *data, size_t size, int scale = 1);
+    // Draw a JPEG file (e.g. downloaded by WebData into LittleFS)
+    void drawImageFile(int32_t x, int32_t y, fs::FS &fs, const String &path, int scale = 1);
+
     // Legacy text function (not using TTF)
     int16_t getLegacyFontHeight();
     void setLegacyTextColor(uint16_t color);
@@ -80,15 +136,60 @@ public:
 
 private:
     uint8_t m_screen_cs[5] = {SCREEN_1_CS, SCREEN_2_CS, SCREEN_3_CS, SCREEN_4_CS, SCREEN_5_CS};
+    // Bit i is set if screen i is currently selected (CS low)
+    uint8_t m_selectedScreens = 0;
     TFT_eSPI &m_tft;
     OpenFontRender m_render;
+    TextLayout m_textLayout{m_render};
     TTF_Font m_curFont = TTF_Font::NONE;
     uint8_t m_brightness = TFT_BRIGHTNESS;
+    TFT_eSprite *m_offscreen[NUM_SCREENS] = {nullptr};
+    bool m_offscreenActive = false;
+
+    struct GlyphCacheUsage {
+        TTF_Font font;
+        GlyphCacheStats stats;
+    };
+    GlyphCacheUsage m_glyphCacheUsage[GLYPH_CACHE_STATS_SIZE];
+    int m_glyphCacheUsageCount = 0;
+    unsigned long m_glyphCachePeak = 0;
+    unsigned long m_glyphCacheTuned = 0;
+
+    struct GlyphSet {
+        TTF_Font font;
+        unsigned int size;
+        String chars;
+    };
+    std::vector<GlyphSet> m_glyphSets; // Sorted by size, see registerGlyphs()
+    size_t m_prewarmSet = 0;
+    unsigned int m_prewarmPos = 0;
+    unsigned long m_prewarmTime = 0;
+    bool m_prewarmDone = false;
 
     TFT_eSPI &getDisplay();
     OpenFontRender &getRender();
+    uint8_t getScreenPin(int screen);
     unsigned int getScaledFontSize(unsigned int fontSize);
     uint16_t dim(uint16_t color);
+    void drawSpan(int32_t x, int32_t y, int32_t w, uint16_t *colors);
+    void collectGlyphCacheStats();
+    unsigned long grownGlyphCacheBudget();
+    void startWrite();
+    void endWrite();
+
+    // Run a draw call on the display or, while rendering off-screen, on the buffers of all selected screens
+    template <typename F>
+    void forEachTarget(F draw) {
+        if (!m_offscreenActive) {
+            draw(m_tft);
+            return;
+        }
+        for (int i = 0; i < NUM_SCREENS; i++) {
+            if (m_selectedScreens & SCREEN_MASK(i)) {
+                draw(*m_offscreen[i]);
+            }
+        }
+    }
 };
 
 #endif // SCREENMANAGER_H
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "TextLayout.h"
+
+TextLayout::TextLayout(OpenFontRender &render) : m_render(render) {}
+
+uint32_t TextLayout::hash(TTF_Font font, unsigned int fontSize, const char *text) {
+    uint32_t h = Utils::fnv1a(&font, sizeof(font));
+    h = Utils::fnv1a(&fontSize, sizeof(fontSize), h);
+    h = Utils::fnv1a(text, strlen(text), h);
+    // 0 marks an empty cache entry
+    return h == 0 ? 1 : h;
+}
+
+// Width in pixels of a single line of text (font must be the currently loaded one)
+int TextLayout::measure(TTF_Font font, unsigned int fontSize, const char *text) {
+    if (strlen(text) > TEXT_LAYOUT_CACHE_TEXT) {
+        return m_render.getTextAdvance(text, fontSize);
+    }
+    uint32_t key = hash(font, fontSize, text);
+    CacheEntry &entry = m_cache[key % TEXT_LAYOUT_CACHE_SIZE];
+    if (entry.key != key || entry.font != font || entry.fontSize != fontSize || strcmp(entry.text, text) != 0) {
+        entry.key = key;
+        entry.font = font;
+        entry.fontSize = fontSize;
+        strcpy(entry.text, text);
+        entry.width = m_render.getTextAdvance(text, fontSize);
+    }
+    return entry.width;
+}
+
+// Greedy word wrap of text into lines no wider than maxWidth, '\n' forces a break.
+// The text buffer is modified in place (line breaks become '\0') and lines point into it, so nothing is allocated.
+// Words that are wider than maxWidth get a line on their own. Returns the number of lines.
+int TextLayout::wrap(TTF_Font font, unsigned int fontSize, char *text, int maxWidth, const char *(&lines)[MAX_WRAPPED_LINES], int maxLines) {
+    maxLines = min(maxLines, MAX_WRAPPED_LINES);
+    int spaceWidth = measure(font, fontSize, " ");
+    int lineCount = 0;
+    int lineWidth = 0;
+    char *lineEnd = nullptr; // End of the last word on the current line
+    char *p = text;
+
+    while (*p) {
+        char *word = p;
+        while (*p && *p != ' ' && *p != '\n') {
+            p++;
+        }
+        char separator = *p;
+        *p = '\0';
+        int wordWidth = word == p ? 0 : measure(font, fontSize, word);
+
+        if (word == p) {
+            // Empty word (repeated spaces), nothing to place
+        } else if (lineEnd != nullptr && lineWidth + spaceWidth + wordWidth <= maxWidth) {
+            // Append to current line, restore the spaces between the words
+            for (char *c = lineEnd; c < word; c++) {
+                *c = ' ';
+            }
+            lineWidth += spaceWidth + wordWidth;
+            lineEnd = p;
+        } else {
+            // Start a new line
+            if (lineCount == maxLines) {
+                break;
+            }
+            lines[lineCount++] = word;
+            lineWidth = wordWidth;
+            lineEnd = p;
+        }
+
+        if (separator == '\0') {
+            break;
+        }
+        p++;
+        if (separator == '\n') {
+            // Forced break, the next word starts a new line
+            lineWidth = maxWidth + 1;
+        }
+    }
+    return lineCount;
+}
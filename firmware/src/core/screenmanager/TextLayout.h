@@ -0,0 +1,43 @@
+#ifndef TEXTLAYOUT_H
+#define TEXTLAYOUT_H
+
+#include "Utils.h"
+#include "ttf-fonts.h"
+#include <OpenFontRender.h>
+
+// Number of cached text measurements
+#ifndef TEXT_LAYOUT_CACHE_SIZE
+    #define TEXT_LAYOUT_CACHE_SIZE 64
+#endif
+
+// Longest text that is cached, longer ones are measured every time
+#ifndef TEXT_LAYOUT_CACHE_TEXT
+    #define TEXT_LAYOUT_CACHE_TEXT 23
+#endif
+
+// Measures and wraps text by the actual glyph advances of a TTF font
+class TextLayout {
+public:
+    TextLayout(OpenFontRender &render);
+
+    int measure(TTF_Font font, unsigned int fontSize, const char *text);
+    int wrap(TTF_Font font, unsigned int fontSize, char *text, int maxWidth, const char *(&lines)[MAX_WRAPPED_LINES], int maxLines = MAX_WRAPPED_LINES);
+
+private:
+    struct CacheEntry {
+        uint32_t key = 0;
+        TTF_Font font = TTF_Font::NONE;
+        unsigned int fontSize = 0;
+        uint16_t width = 0;
+        char text[TEXT_LAYOUT_CACHE_TEXT + 1] = {};
+    };
+
+    OpenFontRender &m_render;
+    // Direct mapped cache of measurements, indexed by a hash of (font, size, text).
+    // Entries keep all three, so texts with the same hash don't get each other's width.
+    CacheEntry m_cache[TEXT_LAYOUT_CACHE_SIZE];
+
+    uint32_t hash(TTF_Font font, unsigned int fontSize, const char *text);
+};
+
+#endif
@@ -0,0 +1,235 @@
+#include "Snapshot.h"
+
+#include "Utils.h"
+#include <LittleFS.h>
+
+#define SNAPSHOT_DIR "/snapshot"
+#define SNAPSHOT_FORMAT_VERSION 1
+#define SNAPSHOT_HEADER_SIZE 16
+
+void SnapshotWriter::writeU8(uint8_t value) {
+    m_data.push_back(value);
+}
+
+void SnapshotWriter::writeU16(uint16_t value) {
+    writeU8(value);
+    writeU8(value >> 8);
+}
+
+void SnapshotWriter::writeU32(uint32_t value) {
+    writeU16(value);
+    writeU16(value >> 16);
+}
+
+void SnapshotWriter::writeI32(int32_t value) {
+    writeU32((uint32_t) value);
+}
+
+void SnapshotWriter::writeFloat(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    writeU32(bits);
+}
+
+// Length prefixed, without the terminating zero
+void SnapshotWriter::writeString(const String &value) {
+    writeU16(value.length());
+    writeBytes((const uint8_t *) value.c_str(), value.length());
+}
+
+void SnapshotWriter::writeBytes(const uint8_t *data, size_t size) {
+    m_data.insert(m_data.end(), data, data + size);
+}
+
+const std::vector<uint8_t> &SnapshotWriter::getData() const {
+    return m_data;
+}
+
+uint32_t SnapshotWriter::getChecksum() const {
+    return Utils::fnv1a(m_data.data(), m_data.size());
+}
+
+bool SnapshotReader::readBytes(uint8_t *data, size_t size) {
+    if (!m_ok || size > remaining()) {
+        m_ok = false;
+        memset(data, 0, size);
+        return false;
+    }
+    memcpy(data, &m_data[m_pos], size);
+    m_pos += size;
+    return true;
+}
+
+uint8_t SnapshotReader::readU8() {
+    uint8_t value;
+    readBytes(&value, 1);
+    return value;
+}
+
+uint16_t SnapshotReader::readU16() {
+    uint16_t low = readU8();
+    return low | (readU8() << 8);
+}
+
+uint32_t SnapshotReader::readU32() {
+    uint32_t low = readU16();
+    return low | ((uint32_t) readU16() << 16);
+}
+
+int32_t SnapshotReader::readI32() {
+    return (int32_t) readU32();
+}
+
+float SnapshotReader::readFloat() {
+    uint32_t bits = readU32();
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+String SnapshotReader::readString() {
+    uint16_t length = readU16();
+    if (!m_ok || length > remaining()) {
+        m_ok = false;
+        return "";
+    }
+    String value;
+    value.concat((const char *) &m_data[m_pos], length);
+    m_pos += length;
+    return value;
+}
+
+size_t SnapshotReader::remaining() {
+    return m_data.size() - m_pos;
+}
+
+bool SnapshotReader::ok() {
+    return m_ok;
+}
+
+Snapshot *Snapshot::m_instance = nullptr;
+
+Snapshot *Snapshot::getInstance() {
+    if (m_instance == nullptr) {
+        m_instance = new Snapshot();
+    }
+    return m_instance;
+}
+
+bool Snapshot::begin() {
+    if (!m_begun) {
+        m_begun = true;
+        m_available = Utils::beginLittleFS();
+        if (m_available) {
+            if (!LittleFS.exists(SNAPSHOT_DIR)) {
+                LittleFS.mkdir(SNAPSHOT_DIR);
+            }
+        } else {
+            Serial.println("Snapshot: LittleFS not available");
+        }
+    }
+    return m_available;
+}
+
+String Snapshot::filePath(const String &name) {
+    return SNAPSHOT_DIR "/" + name + ".bin";
+}
+
+bool Snapshot::restore(const String &name, uint16_t version, SnapshotReader &reader) {
+    if (!begin()) {
+        return false;
+    }
+    unsigned long start = millis();
+    fs::File f = LittleFS.open(filePath(name), "r");
+    if (!f) {
+        return false;
+    }
+    uint8_t header[SNAPSHOT_HEADER_SIZE];
+    bool valid = f.read(header, sizeof(header)) == sizeof(header) && memcmp(header, "SNAP", 4) == 0;
+    uint16_t format = header[4] | (header[5] << 8);
+    uint16_t modelVersion = header[6] | (header[7] << 8);
+    uint32_t size = header[8] | (header[9] << 8) | (header[10] << 16) | ((uint32_t) header[11] << 24);
+    uint32_t sum = header[12] | (header[13] << 8) | (header[14] << 16) | ((uint32_t) header[15] << 24);
+    if (valid && format == SNAPSHOT_FORMAT_VERSION && modelVersion == version && size == f.size() - SNAPSHOT_HEADER_SIZE) {
+        reader.m_data.resize(size);
+        // The checksum catches files that were cut short by a power loss
+        valid = f.read(reader.m_data.data(), size) == size && Utils::fnv1a(reader.m_data.data(), size) == sum;
+    } else {
+        valid = false;
+    }
+    f.close();
+    if (!valid) {
+        Serial.printf("Snapshot: ignoring %s (broken or old version)\n", name.c_str());
+        reader.m_data.clear();
+        return false;
+    }
+    reader.m_pos = 0;
+    reader.m_ok = true;
+    // The same data doesn't need to be written again
+    m_written[name].checksum = sum;
+    Serial.printf("Snapshot: restored %s (%d bytes) in %lu ms\n", name.c_str(), (int) size, millis() - start);
+    return true;
+}
+
+void Snapshot::save(const String &name, uint16_t version, const SnapshotWriter &writer) {
+    uint32_t sum = writer.getChecksum();
+    auto written = m_written.find(name);
+    if (written != m_written.end() && written->second.checksum == sum) {
+        // Back to what's in flash already
+        m_pending.erase(name);
+        return;
+    }
+    m_pending[name] = {version, sum, writer.getData()};
+}
+
+void Snapshot::writePending() {
+    for (auto it = m_pending.begin(); it != m_pending.end();) {
+        Written &written = m_written[it->first];
+        if (written.time != 0 && millis() - written.time < SNAPSHOT_WRITE_INTERVAL) {
+            ++it;
+            continue;
+        }
+        if (write(it->first, it->second)) {
+            written.checksum = it->second.checksum;
+        }
+        // Also after a failed write, so a full or broken file system isn't hammered
+        written.time = millis();
+        it = m_pending.erase(it);
+    }
+}
+
+// Written to a temporary file first, so a power loss keeps the previous snapshot
+bool Snapshot::write(const String &name, const Pending &pending) {
+    if (!begin()) {
+        return false;
+    }
+    unsigned long start = millis();
+    uint32_t size = pending.data.size();
+    uint8_t header[SNAPSHOT_HEADER_SIZE] = {'S', 'N', 'A', 'P',
+                                            SNAPSHOT_FORMAT_VERSION & 0xFF, SNAPSHOT_FORMAT_VERSION >> 8,
+                                            (uint8_t) pending.version, (uint8_t) (pending.version >> 8),
+                                            (uint8_t) size, (uint8_t) (size >> 8), (uint8_t) (size >> 16), (uint8_t) (size >> 24),
+                                            (uint8_t) pending.checksum, (uint8_t) (pending.checksum >> 8), (uint8_t) (pending.checksum >> 16), (uint8_t) (pending.checksum >> 24)};
+    String path = filePath(name);
+    String temp = SNAPSHOT_DIR "/" + name + ".tmp";
+    fs::File f = LittleFS.open(temp, "w");
+    if (!f) {
+        Serial.printf("Snapshot: cannot write %s\n", name.c_str());
+        return false;
+    }
+    bool ok = f.write(header, sizeof(header)) == sizeof(header) && f.write(pending.data.data(), size) == size;
+    f.close();
+    if (!ok) {
+        Serial.printf("Snapshot: cannot write %s\n", name.c_str());
+        LittleFS.remove(temp);
+        return false;
+    }
+    // rename() replaces the old snapshot atomically, removing it first would leave a gap without one
+    if (!LittleFS.rename(temp, path)) {
+        Serial.printf("Snapshot: cannot replace %s\n", name.c_str());
+        LittleFS.remove(temp);
+        return false;
+    }
+    Serial.printf("Snapshot: saved %s (%d bytes) in %lu ms\n", name.c_str(), (int) size, millis() - start);
+    return true;
+}
@@ -0,0 +1,92 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <Arduino.h>
+#include <map>
+#include <vector>
+
+// A changed snapshot is written at most once per this many ms (flash wear), the first one after boot right away
+#ifndef SNAPSHOT_WRITE_INTERVAL
+    #define SNAPSHOT_WRITE_INTERVAL 600000
+#endif
+
+// Collects the fields of a data model in a compact little-endian buffer
+class SnapshotWriter {
+public:
+    void writeU8(uint8_t value);
+    void writeU16(uint16_t value);
+    void writeU32(uint32_t value);
+    void writeI32(int32_t value);
+    void writeFloat(float value);
+    void writeString(const String &value);
+    void writeBytes(const uint8_t *data, size_t size);
+    const std::vector<uint8_t> &getData() const;
+    uint32_t getChecksum() const;
+
+private:
+    std::vector<uint8_t> m_data;
+};
+
+// Reads the fields back in the order they were written.
+// Reads past the end return zero or an empty string and make ok() false.
+class SnapshotReader {
+public:
+    uint8_t readU8();
+    uint16_t readU16();
+    uint32_t readU32();
+    int32_t readI32();
+    float readFloat();
+    String readString();
+    bool readBytes(uint8_t *data, size_t size);
+    size_t remaining();
+    bool ok();
+
+private:
+    friend class Snapshot;
+    std::vector<uint8_t> m_data;
+    size_t m_pos = 0;
+    bool m_ok = true;
+};
+
+// Last known data of the widgets in LittleFS, so the first frame after a reboot
+// shows it while the widgets fetch fresh data.
+// Every snapshot is a file with a header (magic, format and model version, size, checksum)
+// and the fields of the model. Files are replaced atomically, unchanged data is never written again.
+class Snapshot {
+public:
+    static Snapshot *getInstance();
+
+    // Load the snapshot called name into reader. Returns false if there is none,
+    // it's broken or it was written for another version of the model.
+    bool restore(const String &name, uint16_t version, SnapshotReader &reader);
+    // Queue the data of a model for writing, called after every successful refresh
+    void save(const String &name, uint16_t version, const SnapshotWriter &writer);
+    // Write the queued snapshots that are due, called from the main loop
+    void writePending();
+
+private:
+    struct Pending {
+        uint16_t version;
+        uint32_t checksum;
+        std::vector<uint8_t> data;
+    };
+    struct Written {
+        uint32_t checksum = 0;
+        unsigned long time = 0; // millis() of the last write, 0 if not written since boot
+    };
+
+    Snapshot() = default;
+
+    bool begin();
+    String filePath(const String &name);
+    bool write(const String &name, const Pending &pending);
+
+    static Snapshot *m_instance;
+
+    std::map<String, Pending> m_pending;
+    std::map<String, Written> m_written;
+    bool m_begun = false;
+    bool m_available = false;
+};
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,263 @@
+#include "InflateStream.h"
+
+#define GZIP_FLAG_HCRC 0x02
+#define GZIP_FLAG_EXTRA 0x04
+#define GZIP_FLAG_NAME 0x08
+#define GZIP_FLAG_COMMENT 0x10
+
+InflateStream::~InflateStream() {
+#ifdef BENCHMARK
+    if (m_outTotal > 0) {
+        Serial.printf("Inflated %u to %u bytes in %lu ms\n", m_inTotal, m_outTotal, millis() - m_start);
+    }
+#endif
+    release();
+}
+
+void InflateStream::prepare(HTTPClient &http) {
+    http.useHTTP10(true);
+#if HTTP_COMPRESSION
+    if (allocate()) {
+        if (ESP.getMaxAllocHeap() >= INFLATE_MIN_FREE_HEAP) {
+            http.addHeader("Accept-Encoding", "gzip, deflate");
+        } else {
+            release();
+        }
+    }
+#endif
+}
+
+void InflateStream::begin(Stream &source) {
+    m_source = &source;
+    m_mode = DETECT;
+    m_inPos = m_inEnd = 0;
+    m_outPos = m_outEnd = 0;
+    m_sourceEnded = false;
+#ifdef BENCHMARK
+    m_start = millis();
+#endif
+}
+
+bool InflateStream::allocate() {
+    if (m_window == nullptr) {
+        m_decompressor = (tinfl_decompressor *) malloc(sizeof(tinfl_decompressor));
+        m_window = (uint8_t *) malloc(TINFL_LZ_DICT_SIZE);
+        if (m_decompressor == nullptr || m_window == nullptr) {
+            release();
+            return false;
+        }
+    }
+    return true;
+}
+
+void InflateStream::release() {
+    free(m_decompressor);
+    free(m_window);
+    m_decompressor = nullptr;
+    m_window = nullptr;
+}
+
+// Whatever has arrived already, but at least one byte (waits up to the timeout of the source)
+void InflateStream::readInput() {
+    size_t count = constrain(m_source->available(), 1, INFLATE_INPUT_SIZE);
+    m_inPos = 0;
+    m_inEnd = m_source->readBytes(m_input, count);
+    m_sourceEnded = m_inEnd == 0;
+#ifdef BENCHMARK
+    m_inTotal += m_inEnd;
+#endif
+}
+
+int InflateStream::nextInput() {
+    if (m_inPos == m_inEnd) {
+        if (m_sourceEnded) {
+            return -1;
+        }
+        readInput();
+        if (m_inPos == m_inEnd) {
+            return -1;
+        }
+    }
+    return m_input[m_inPos++];
+}
+
+// Looks at the first two bytes, servers that ignore Accept-Encoding send plain JSON
+void InflateStream::detect() {
+    m_mode = DONE;
+    if (m_source == nullptr) {
+        return;
+    }
+    readInput();
+    if (m_inEnd == 1) {
+        m_inEnd += m_source->readBytes(m_input + 1, 1);
+    }
+    m_mode = PLAIN;
+    if (m_inEnd < 2) {
+        return;
+    }
+    if (m_input[0] == 0x1F && m_input[1] == 0x8B) {
+        if (!skipGzipHeader()) {
+            Serial.println("InflateStream: broken gzip header");
+            m_mode = DONE;
+            return;
+        }
+        m_flags = 0;
+    } else if (m_input[0] == 0x78 && ((m_input[0] << 8) | m_input[1]) % 31 == 0) {
+        // zlib with a 32 KB window, JSON never starts with an 'x'
+        m_flags = TINFL_FLAG_PARSE_ZLIB_HEADER;
+    } else {
+        return;
+    }
+    if (!allocate()) {
+        Serial.println("InflateStream: not enough memory");
+        m_mode = DONE;
+        return;
+    }
+    tinfl_init(m_decompressor);
+    m_windowPos = 0;
+    m_mode = INFLATE;
+}
+
+// Magic, method, flags, time, extra flags and OS, followed by the optional fields
+bool InflateStream::skipGzipHeader() {
+    uint8_t header[10];
+    for (int i = 0; i < 10; i++) {
+        int c = nextInput();
+        if (c < 0) {
+            return false;
+        }
+        header[i] = c;
+    }
+    if (header[2] != 8) {
+        // Deflate is the only method
+        return false;
+    }
+    uint8_t flags = header[3];
+    if (flags & GZIP_FLAG_EXTRA) {
+        int low = nextInput();
+        int high = nextInput();
+        if (low < 0 || high < 0) {
+            return false;
+        }
+        for (int length = low | (high << 8); length > 0; length--) {
+            if (nextInput() < 0) {
+                return false;
+            }
+        }
+    }
+    for (int field : {GZIP_FLAG_NAME, GZIP_FLAG_COMMENT}) {
+        if (flags & field) {
+            // Zero terminated
+            int c;
+            do {
+                c = nextInput();
+            } while (c > 0);
+            if (c < 0) {
+                return false;
+            }
+        }
+    }
+    if (flags & GZIP_FLAG_HCRC) {
+        nextInput();
+        if (nextInput() < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Inflates into the window until there is output to read, false at the end (or on errors).
+// The window is used as a ring, tinfl needs the previous 32 KB of output to resolve back references.
+bool InflateStream::fill() {
+    while (m_outPos == m_outEnd) {
+        if (m_mode != INFLATE) {
+            return false;
+        }
+        if (m_inPos == m_inEnd && !m_sourceEnded) {
+            readInput();
+        }
+        if (m_windowPos == TINFL_LZ_DICT_SIZE) {
+            m_windowPos = 0;
+        }
+        size_t inBytes = m_inEnd - m_inPos;
+        size_t outBytes = TINFL_LZ_DICT_SIZE - m_windowPos;
+        int flags = m_flags | (m_sourceEnded ? 0 : TINFL_FLAG_HAS_MORE_INPUT);
+        tinfl_status status = tinfl_decompress(m_decompressor, m_input + m_inPos, &inBytes, m_window, m_window + m_windowPos, &outBytes, flags);
+        m_inPos += inBytes;
+        m_outPos = m_windowPos;
+        m_outEnd = m_windowPos + outBytes;
+        m_windowPos = m_outEnd;
+#ifdef BENCHMARK
+        m_outTotal += outBytes;
+#endif
+        if (status == TINFL_STATUS_DONE) {
+            // The gzip trailer (CRC and size) is left unread, a broken body fails parsing anyway
+            m_mode = DONE;
+        } else if (status < TINFL_STATUS_DONE) {
+            Serial.printf("InflateStream: broken response (%d)\n", status);
+            m_mode = DONE;
+        }
+    }
+    return true;
+}
+
+int InflateStream::available() {
+    if (m_mode == DETECT) {
+        detect();
+    }
+    if (m_mode == PLAIN) {
+        return (m_inEnd - m_inPos) + m_source->available();
+    }
+    return fill() ? m_outEnd - m_outPos : 0;
+}
+
+int InflateStream::read() {
+    if (m_mode == DETECT) {
+        detect();
+    }
+    if (m_mode == PLAIN) {
+        return m_inPos < m_inEnd ? m_input[m_inPos++] : m_source->read();
+    }
+    return fill() ? m_window[m_outPos++] : -1;
+}
+
+int InflateStream::peek() {
+    if (m_mode == DETECT) {
+        detect();
+    }
+    if (m_mode == PLAIN) {
+        return m_inPos < m_inEnd ? m_input[m_inPos] : m_source->peek();
+    }
+    return fill() ? m_window[m_outPos] : -1;
+}
+
+// deserializeJson() reads through this, one byte at a time
+size_t InflateStream::readBytes(char *buffer, size_t length) {
+    if (m_mode == DETECT) {
+        detect();
+    }
+    size_t count = 0;
+    if (m_mode == PLAIN) {
+        count = min(length, m_inEnd - m_inPos);
+        memcpy(buffer, m_input + m_inPos, count);
+        m_inPos += count;
+        if (count < length) {
+            count += m_source->readBytes(buffer + count, length - count);
+        }
+        return count;
+    }
+    while (count < length && fill()) {
+        size_t chunk = min(length - count, m_outEnd - m_outPos);
+        memcpy(buffer + count, m_window + m_outPos, chunk);
+        m_outPos += chunk;
+        count += chunk;
+    }
+    return count;
+}
+
+size_t InflateStream::write(uint8_t) {
+    return 0;
+}
+
+void InflateStream::flush() {
+}
@@ -0,0 +1,87 @@
+#ifndef INFLATE_STREAM_H
+#define INFLATE_STREAM_H
+
+#include <Arduino.h>
+#include <HTTPClient.h>
+#include <rom/miniz.h>
+
+// Ask the APIs for gzip compressed JSON (set to false to always fetch it uncompressed)
+#ifndef HTTP_COMPRESSION
+    #define HTTP_COMPRESSION true
+#endif
+
+// Largest free heap block that has to be left after reserving the inflate buffers,
+// the TLS connection is set up after that. Below it the response is fetched uncompressed.
+#ifndef INFLATE_MIN_FREE_HEAP
+    #define INFLATE_MIN_FREE_HEAP 40000
+#endif
+
+#define INFLATE_INPUT_SIZE 512
+
+// Decompresses a gzip or zlib (Content-Encoding deflate) response while it is read,
+// so deserializeJson() can parse it straight from the connection. Uncompressed responses
+// are passed through, the format is recognized by the first bytes.
+// Deflate can refer back up to 32 KB, so that's the size of the window buffer. It and the
+// decompressor (about 11 KB) are only allocated for the duration of a compressed request.
+//
+//   InflateStream body;
+//   http.begin(url);
+//   body.prepare(http);
+//   if (http.GET() == 200) {
+//       body.begin(http.getStream());
+//       deserializeJson(doc, body);
+//   }
+class InflateStream : public Stream {
+public:
+    InflateStream() = default;
+    ~InflateStream() override;
+
+    // Call after http.begin(). Switches to HTTP/1.0, which has no chunked responses and makes
+    // HTTPClient leave out its own Accept-Encoding, and asks for gzip if the buffers fit.
+    void prepare(HTTPClient &http);
+    // The response body to read from, after GET()/POST()
+    void begin(Stream &source);
+
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t readBytes(char *buffer, size_t length) override;
+    size_t write(uint8_t) override;
+    void flush() override;
+
+private:
+    enum Mode {
+        DETECT,
+        PLAIN,
+        INFLATE,
+        DONE
+    };
+
+    bool allocate();
+    void release();
+    void detect();
+    bool skipGzipHeader();
+    void readInput();
+    int nextInput();
+    bool fill();
+
+    Stream *m_source = nullptr;
+    Mode m_mode = DETECT;
+    tinfl_decompressor *m_decompressor = nullptr;
+    uint8_t *m_window = nullptr; // TINFL_LZ_DICT_SIZE, also the output buffer
+    int m_flags = 0;
+    size_t m_windowPos = 0; // Where the next output goes
+    size_t m_outPos = 0; // Output not read yet is between m_outPos and m_outEnd
+    size_t m_outEnd = 0;
+    uint8_t m_input[INFLATE_INPUT_SIZE];
+    size_t m_inPos = 0;
+    size_t m_inEnd = 0;
+    bool m_sourceEnded = false;
+#ifdef BENCHMARK
+    unsigned long m_start = 0;
+    size_t m_inTotal = 0;
+    size_t m_outTotal = 0;
+#endif
+};
+
+#endif // INFLATE_STREAM_H
@@ -1,76 +1,6 @@
 #include "Utils.h"
 
-int Utils::getWrappedLines(String (&lines)[MAX_WRAPPED_LINES], String str, int limit) {
-    char buf[str.length() + 1];
-    char lineBuf[limit + 1];
-    str.toCharArray(buf, str.length() + 1);
-
-    char *p = buf;
-    char *eol;
-    int lineCount = 0;
-    for (int i = 0; i < MAX_WRAPPED_LINES; i++) {
-        if (p - buf > strlen(buf)) {
-            lines[i] = "";
-            continue;
-        }
-        eol = strchr(p, '\n');
-        if (eol == NULL) {
-            eol = p + strlen(p);
-        }
-
-        if (eol - p > limit) {
-            eol = p + limit;
-            while (*eol != ' ' && *eol != '\n' && eol > p) {
-                eol--;
-            }
-        }
-        strncpy(lineBuf, p, eol - p);
-        lineBuf[eol - p] = '\0';
-
-        lines[i] = String(lineBuf);
-        lineCount++;
-        p = eol + 1;
-    }
-    return lineCount;
-}
-
-String Utils::getWrappedLine(String str, int limit, int lineNum, int maxLines) {
-    if (lineNum > maxLines) {
-        return "";
-    }
-    char buf[str.length() + 1];
-    char lineBuf[limit + 1];
-    str.toCharArray(buf, str.length() + 1);
-
-    String lines[maxLines];
-
-    char *p = buf;
-    char *eol;
-
-    for (int i = 0; i < maxLines && i <= lineNum; i++) {
-        if (p - buf > strlen(buf)) {
-            lines[i] = "";
-            continue;
-        }
-        eol = strchr(p, '\n');
-        if (eol == NULL) {
-            eol = p + strlen(p);
-        }
-
-        if (eol - p > limit) {
-            eol = p + limit;
-            while (*eol != ' ' && *eol != '\n' && eol > p) {
-                eol--;
-            }
-        }
-        strncpy(lineBuf, p, eol - p);
-        lineBuf[eol - p] = '\0';
-
-        lines[i] = String(lineBuf);
-        p = eol + 1;
-    }
-    return lines[lineNum];
-}
+#include <LittleFS.h>
 
 int32_t Utils::stringToColor(String color) {
     color.toLowerCase();
@@ -211,3 +141,26 @@ uint16_t Utils::rgb565dim(uint16_t color, uint8_t brightness, bool swapBytes) {
     }
     return result;
 }
+
+uint32_t Utils::fnv1a(const void *data, size_t size, uint32_t hash) {
+    const uint8_t *bytes = (const uint8_t *) data;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+uint32_t Utils::fnv1a(const String &text) {
+    return fnv1a(text.c_str(), text.length());
+}
+
+bool Utils::beginLittleFS() {
+    static bool begun = false;
+    static bool available = false;
+    if (!begun) {
+        begun = true;
+        // Format on the first start (or after the partition table changed)
+        available = LittleFS.begin(true);
+    }
+    return available;
+}
@@ -16,14 +16,19 @@ enum ScreenMode {
 #define ScreenCenterX (ScreenWidth / 2)
 #define ScreenCenterY (ScreenHeight / 2)
 
+#define FNV1A_INITIAL 2166136261u
+
 class Utils {
 public:
-    static int getWrappedLines(String (&lines)[MAX_WRAPPED_LINES], String str, int limit);
-    static String getWrappedLine(String str, int limit, int lineNum, int maxLines);
     static int32_t stringToColor(String color);
     static String formatFloat(float value, int8_t digits);
     static int32_t stringToAlignment(String alignment);
     static uint16_t rgb565dim(uint16_t color, uint8_t brightness, bool swapBytes = false);
+    // FNV-1a hash, pass the previous result as hash to continue it over more data
+    static uint32_t fnv1a(const void *data, size_t size, uint32_t hash = FNV1A_INITIAL);
+    static uint32_t fnv1a(const String &text);
+    // Mounts LittleFS on the first call, shared by everything that keeps files
+    static bool beginLittleFS();
 };
 
 #endif
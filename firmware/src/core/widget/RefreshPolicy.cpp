@@ -0,0 +1,88 @@
+#include "RefreshPolicy.h"
+
+#include "TimeZoneRule.h"
+
+RefreshPolicy::RefreshPolicy(unsigned long interval, bool marketHours) : m_interval(interval), m_marketHours(marketHours && MARKET_HOURS) {}
+
+void RefreshPolicy::setInterval(unsigned long interval) {
+    m_interval = interval;
+}
+
+unsigned long RefreshPolicy::getInterval(bool visible) {
+    unsigned long interval = m_interval << min(m_unchanged, (uint8_t) REFRESH_UNCHANGED_MAX_STEPS);
+    return visible ? interval : interval * REFRESH_BACKGROUND_FACTOR;
+}
+
+bool RefreshPolicy::isDue(bool visible) {
+    if (m_marketHours) {
+        if (isMarketOpen()) {
+            m_fetchedWhileClosed = false;
+        } else if (m_fetchedWhileClosed) {
+            // Closing values are there, nothing changes until the exchange opens
+            return false;
+        }
+    }
+    return m_due || millis() - m_lastAttempt >= getInterval(visible);
+}
+
+long RefreshPolicy::getMillisToNext(bool visible) {
+    if (m_marketHours && m_fetchedWhileClosed && !isMarketOpen()) {
+        // Check the trading hours again in a minute
+        return 60000;
+    }
+    if (m_due) {
+        return 0;
+    }
+    return (long) getInterval(visible) - (long) (millis() - m_lastAttempt);
+}
+
+void RefreshPolicy::fetched(uint32_t checksum) {
+    if (m_fetched && checksum == m_checksum) {
+        if (m_unchanged < REFRESH_UNCHANGED_MAX_STEPS) {
+            m_unchanged++;
+        }
+    } else {
+        m_unchanged = 0;
+    }
+    m_checksum = checksum;
+    m_fetched = true;
+    m_failed = false;
+    m_due = false;
+    m_lastFetch = millis();
+    m_lastAttempt = m_lastFetch;
+    m_fetchedWhileClosed = m_marketHours && !isMarketOpen();
+}
+
+void RefreshPolicy::failed(bool endpointDown) {
+    m_failed = true;
+    // A server that answers with an error or broken data would answer the same right away
+    m_due = endpointDown;
+    m_lastAttempt = millis();
+}
+
+// Restored snapshots are not stale until the first fetch failed
+bool RefreshPolicy::isStale() {
+    return m_failed && (!m_fetched || millis() - m_lastFetch >= getInterval(true) * REFRESH_STALE_FACTOR);
+}
+
+void RefreshPolicy::reset() {
+    m_due = true;
+    m_unchanged = 0;
+    m_fetchedWhileClosed = false;
+}
+
+// Weekdays between MARKET_OPEN and MARKET_CLOSE in MARKET_TIMEZONE, holidays are not known.
+// Counts as open while the time is not known yet.
+bool RefreshPolicy::isMarketOpen() {
+    static TimeZoneRule rule;
+    static bool hasRule = rule.setLocation(MARKET_TIMEZONE);
+    time_t utc = time(nullptr);
+    if (!hasRule || utc < 1700000000) {
+        return true;
+    }
+    time_t nextChange;
+    time_t local = utc + rule.getOffset(utc, nextChange);
+    int weekday = (local / 86400 + 4) % 7; // 1970-01-01 was a Thursday, 0 = Sunday
+    int hhmm = (local % 86400) / 3600 * 100 + (local % 3600) / 60;
+    return weekday >= 1 && weekday <= 5 && hhmm >= MARKET_OPEN && hhmm < MARKET_CLOSE;
+}
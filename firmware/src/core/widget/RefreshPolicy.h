@@ -0,0 +1,71 @@
+#ifndef REFRESH_POLICY_H
+#define REFRESH_POLICY_H
+
+#include <Arduino.h>
+
+// Widgets that are not on screen (and not about to be shown) refresh this many times less often
+#ifndef REFRESH_BACKGROUND_FACTOR
+    #define REFRESH_BACKGROUND_FACTOR 4
+#endif
+
+// Every fetch that returns the same data doubles the interval, up to this many times
+#ifndef REFRESH_UNCHANGED_MAX_STEPS
+    #define REFRESH_UNCHANGED_MAX_STEPS 3
+#endif
+
+// Data counts as stale when fetches failed and the last good one is this many intervals ago
+#ifndef REFRESH_STALE_FACTOR
+    #define REFRESH_STALE_FACTOR 3
+#endif
+
+// Trading hours of the exchange, stock and Parqet fetches pause outside of them (set MARKET_HOURS to false to disable)
+#ifndef MARKET_HOURS
+    #define MARKET_HOURS true
+#endif
+#ifndef MARKET_TIMEZONE
+    #define MARKET_TIMEZONE "America/New_York"
+#endif
+#ifndef MARKET_OPEN
+    #define MARKET_OPEN 930 // Local time of the exchange as HHMM
+#endif
+#ifndef MARKET_CLOSE
+    #define MARKET_CLOSE 1600
+#endif
+
+// Decides when a widget fetches its data again. The configured interval is used while the
+// widget is visible, it gets longer in the background and while fetches keep returning the same data.
+// Market data is fetched once more after the exchange closed and then not until it opens again.
+class RefreshPolicy {
+public:
+    RefreshPolicy(unsigned long interval, bool marketHours = false);
+    void setInterval(unsigned long interval);
+    bool isDue(bool visible);
+    long getMillisToNext(bool visible);
+    // After a successful fetch, checksum identifies the data to notice when nothing changed
+    void fetched(uint32_t checksum);
+    // After a failed fetch. If the endpoint is down (EndpointHealth backs off) the policy stays due
+    // and EndpointHealth decides when to try again, otherwise it waits for the normal interval.
+    void failed(bool endpointDown);
+    // Fetches keep failing and the data is old, widgets show an indicator
+    bool isStale();
+    // Fetch on the next check, e.g. after a button press
+    void reset();
+
+    static bool isMarketOpen();
+
+private:
+    unsigned long getInterval(bool visible);
+
+    unsigned long m_interval;
+    bool m_marketHours;
+    bool m_fetched = false;
+    bool m_due = true;
+    unsigned long m_lastFetch = 0; // Last successful fetch
+    unsigned long m_lastAttempt = 0; // Last fetch, also a failed one
+    bool m_failed = false; // The last fetch failed
+    uint32_t m_checksum = 0;
+    uint8_t m_unchanged = 0; // Fetches in a row that returned the same data
+    bool m_fetchedWhileClosed = false;
+};
+
+#endif // REFRESH_POLICY_H
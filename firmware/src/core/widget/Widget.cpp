@@ -2,6 +2,19 @@
 
 Widget::Widget(ScreenManager &manager) : m_manager(manager) {}
 
+void Widget::setVisible(bool visible) {
+    m_visible = visible;
+}
+
+bool Widget::isVisible() {
+    return m_visible;
+}
+
+void Widget::drawStaleIndicator(int screen) {
+    m_manager.selectScreen(screen);
+    m_manager.fillCircle(SCREEN_SIZE / 2, SCREEN_SIZE - 10, 4, TFT_ORANGE);
+}
+
 void Widget::setBusy(bool busy) {
     if (busy) {
         digitalWrite(BUSY_PIN, HIGH);
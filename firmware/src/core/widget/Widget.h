@@ -4,6 +4,7 @@
 #include "Button.h"
 #include "ScreenManager.h"
 #include "config_helper.h"
+#include <climits>
 
 class Widget {
 public:
@@ -12,11 +13,21 @@ public:
     virtual void setup() = 0;
     virtual void update(bool force = false) = 0;
     virtual void draw(bool force = false) = 0;
+    // Called shortly before the widget becomes visible to fetch data that is due (must not draw)
+    virtual void prefetch() {}
+    // Time in ms until update() or draw() have something to do without user input, the main loop sleeps until then
+    virtual long getMillisToNextUpdate() { return LONG_MAX; }
     virtual void buttonPressed(uint8_t buttonId, ButtonState state) = 0;
     virtual String getName() = 0;
     void setBusy(bool busy);
+    // Visible widgets (and the one about to be shown) refresh their data more often
+    void setVisible(bool visible);
+    bool isVisible();
+    // Small dot at the bottom of a screen, drawn over stale data
+    void drawStaleIndicator(int screen);
 
 protected:
     ScreenManager &m_manager;
+    bool m_visible = false;
 };
 #endif // WIDGET_H
\ No newline at end of file
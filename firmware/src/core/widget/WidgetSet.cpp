@@ -1,6 +1,9 @@
 #include "WidgetSet.h"
 
 WidgetSet::WidgetSet(ScreenManager *sm) : m_screenManager(sm) {
+#if WIDGET_PRERENDER
+    m_prerender = m_screenManager->initOffscreenBuffers();
+#endif
 }
 void WidgetSet::add(Widget *widget) {
     if (m_widgetCount == MAX_WIDGETS) {
@@ -8,6 +11,7 @@ void WidgetSet::add(Widget *widget) {
         return;
     }
     m_widgets[m_widgetCount] = widget;
+    m_widgets[m_widgetCount]->setVisible(m_widgetCount == m_currentWidget);
     m_widgets[m_widgetCount]->setup();
     m_widgetCount++;
 }
@@ -24,6 +28,7 @@ void WidgetSet::drawCurrent(bool force) {
 
 void WidgetSet::updateCurrent() {
     m_widgets[m_currentWidget]->update();
+    m_hasData[m_currentWidget] = true;
 }
 
 Widget *WidgetSet::getCurrent() {
@@ -39,6 +44,7 @@ void WidgetSet::setClearScreensOnDrawCurrent() {
 }
 
 void WidgetSet::next() {
+    m_lastDirection = 1;
     m_currentWidget++;
     if (m_currentWidget >= m_widgetCount) {
         m_currentWidget = 0;
@@ -47,6 +53,7 @@ void WidgetSet::next() {
 }
 
 void WidgetSet::prev() {
+    m_lastDirection = -1;
     m_currentWidget--;
     if (m_currentWidget < 0) {
         m_currentWidget = m_widgetCount - 1;
@@ -55,41 +62,96 @@ void WidgetSet::prev() {
 }
 
 void WidgetSet::switchWidget() {
-    m_screenManager->clearAllScreens();
-    getCurrent()->setup();
+    for (int8_t i = 0; i < m_widgetCount; i++) {
+        m_widgets[i]->setVisible(i == m_currentWidget);
+    }
     uint32_t start = millis();
-    getCurrent()->draw(true);
-    uint32_t end = millis();
-    Serial.printf("Drawing of %s took %d ms\n", getCurrent()->getName().c_str(), (end - start));
+    if (m_preparedWidget == m_currentWidget) {
+        // Already rendered by prepareNext(), just show it
+        m_screenManager->pushOffscreen();
+        uint32_t end = millis();
+        Serial.printf("Showing prepared %s took %d ms\n", getCurrent()->getName().c_str(), (end - start));
+    } else {
+        m_screenManager->clearAllScreens();
+        getCurrent()->setup();
+        start = millis();
+        getCurrent()->draw(true);
+        uint32_t end = millis();
+        Serial.printf("Drawing of %s took %d ms\n", getCurrent()->getName().c_str(), (end - start));
+    }
+    m_preparedWidget = -1;
+    m_prefetchedWidget = -1;
+}
+
+int8_t WidgetSet::getNeighbour(int8_t direction) {
+    return (m_currentWidget + direction + m_widgetCount) % m_widgetCount;
+}
+
+int8_t WidgetSet::getLastDirection() {
+    return m_lastDirection;
 }
 
-void WidgetSet::showCenteredLine(int screen, const String &text) {
-    m_screenManager->selectScreen(screen);
-    m_screenManager->fillScreen(TFT_BLACK);
-    m_screenManager->setFontColor(TFT_WHITE);
-    m_screenManager->drawCentreString(text, ScreenCenterX, ScreenCenterY, 22);
+// Fetch data for the widget that is expected to be shown next (1 = next, -1 = prev),
+// so the first frame after switching to it is fresh without waiting for the network
+void WidgetSet::prefetch(int8_t direction) {
+    if (m_widgetCount < 2) {
+        return;
+    }
+    int8_t neighbour = getNeighbour(direction);
+    // It's about to be shown, so it refreshes like a visible widget
+    m_widgets[neighbour]->setVisible(true);
+    m_widgets[neighbour]->prefetch();
+    m_widgets[neighbour]->setVisible(false);
+    m_prefetchedWidget = neighbour;
+    m_hasData[neighbour] = true;
 }
 
-void WidgetSet::showLoading() {
-    showCenteredLine(3, "Loading data:");
+bool WidgetSet::isPrefetched(int8_t direction) {
+    return m_widgetCount < 2 || m_prefetchedWidget == getNeighbour(direction);
 }
 
-void WidgetSet::updateAll() {
-    for (int8_t i; i < m_widgetCount; i++) {
-        Serial.printf("updating widget %s\n", m_widgets[i]->getName().c_str());
-        showCenteredLine(4, m_widgets[i]->getName());
-        m_widgets[i]->update();
+// Render the next widget into the off-screen buffers, so switching to it
+// with next() only has to push the finished frames
+void WidgetSet::prepareNext() {
+    if (!m_prerender || m_widgetCount < 2) {
+        return;
+    }
+    int8_t next = (m_currentWidget + 1) % m_widgetCount;
+    if (m_preparedWidget == next) {
+        return;
     }
+    uint32_t start = millis();
+    m_screenManager->beginOffscreen();
+    m_screenManager->clearAllScreens();
+    m_widgets[next]->setup();
+    m_widgets[next]->draw(true);
+    m_screenManager->endOffscreen();
+    m_preparedWidget = next;
+    uint32_t end = millis();
+    Serial.printf("Preparing %s took %d ms\n", m_widgets[next]->getName().c_str(), (end - start));
 }
 
 bool WidgetSet::initialUpdateDone() {
     return m_initialized;
 }
 
-void WidgetSet::initializeAllWidgetsData() {
-    showLoading();
-    updateAll();
+// Fetch the data of one widget that has none yet, starting with the one that will be shown next.
+// Called once per loop after the first frame, so the current widget keeps running between the fetches.
+// Returns false when every widget has its data.
+bool WidgetSet::initializeNextWidget() {
+    for (int8_t i = 1; i <= m_widgetCount; i++) {
+        int8_t index = getNeighbour(i * m_lastDirection);
+        if (!m_hasData[index]) {
+            uint32_t start = millis();
+            m_widgets[index]->update();
+            m_hasData[index] = true;
+            uint32_t end = millis();
+            Serial.printf("Initializing %s took %d ms\n", m_widgets[index]->getName().c_str(), (end - start));
+            return true;
+        }
+    }
     m_initialized = true;
+    return false;
 }
 
 void WidgetSet::updateBrightnessByTime(uint8_t hour24) {
@@ -106,7 +168,8 @@ void WidgetSet::updateBrightnessByTime(uint8_t hour24) {
 
     uint8_t brightness = isInDimRange ? DIM_BRIGHTNESS : TFT_BRIGHTNESS;
     if (m_screenManager->setBrightness(brightness)) {
-        // brightness was changed -> update widget
+        // brightness was changed -> update widget and discard the prepared one
+        m_preparedWidget = -1;
         m_screenManager->clearAllScreens();
         drawCurrent(true);
     }
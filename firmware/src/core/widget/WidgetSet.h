@@ -7,6 +7,31 @@
 
 #define MAX_WIDGETS 5
 
+// When cycling, start prefetching data for the next widget this many ms before it is due
+#ifndef WIDGET_PREFETCH_LEAD
+    #define WIDGET_PREFETCH_LEAD 5000
+#endif
+
+// Without cycling, prefetch data for the widget the user is expected to switch to after this many ms
+#ifndef WIDGET_PREFETCH_IDLE
+    #define WIDGET_PREFETCH_IDLE 500
+#endif
+
+// Render the next widget into off-screen buffers before switching to it (needs PSRAM)
+#ifndef WIDGET_PRERENDER
+    #define WIDGET_PRERENDER false
+#endif
+
+// When cycling, start rendering the next widget this many ms before it is due
+#ifndef WIDGET_PRERENDER_LEAD
+    #define WIDGET_PRERENDER_LEAD 2000
+#endif
+
+// Without cycling, render the next widget after this many ms without a button press
+#ifndef WIDGET_PRERENDER_IDLE
+    #define WIDGET_PRERENDER_IDLE 1000
+#endif
+
 class WidgetSet {
 public:
     WidgetSet(ScreenManager *sm);
@@ -16,24 +41,31 @@ public:
     Widget *getCurrent();
     void next();
     void prev();
+    void prepareNext();
+    void prefetch(int8_t direction);
+    bool isPrefetched(int8_t direction);
+    int8_t getLastDirection();
     void buttonPressed(uint8_t buttonId, ButtonState state);
-    void showLoading();
-    void updateAll();
     bool initialUpdateDone();
-    void initializeAllWidgetsData();
+    bool initializeNextWidget();
     void setClearScreensOnDrawCurrent();
     void updateBrightnessByTime(uint8_t hour24);
 
 private:
-    void showCenteredLine(int screen, const String &text);
     ScreenManager *m_screenManager;
     bool m_clearScreensOnDrawCurrent = true;
     Widget *m_widgets[MAX_WIDGETS];
     int8_t m_widgetCount = 0;
     int8_t m_currentWidget = 0;
+    int8_t m_preparedWidget = -1; // Widget currently rendered in the off-screen buffers (-1 for none)
+    bool m_prerender = false;
+    int8_t m_prefetchedWidget = -1; // Widget prefetched since the last switch (-1 for none)
+    int8_t m_lastDirection = 1; // Direction of the last switch (1 = next, -1 = prev)
 
     bool m_initialized = false;
+    bool m_hasData[MAX_WIDGETS] = {}; // Widget fetched its data at least once since boot
 
     void switchWidget();
+    int8_t getNeighbour(int8_t direction);
 };
 #endif // WIDGET_SET_H
\ No newline at end of file
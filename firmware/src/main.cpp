@@ -1,6 +1,9 @@
+#include "AssetStore.h"
 #include "Button.h"
 #include "GlobalTime.h"
+#include "Scheduler.h"
 #include "ScreenManager.h"
+#include "Snapshot.h"
 #include "Utils.h"
 #include "WidgetSet.h"
 #include "clockwidget/ClockWidget.h"
@@ -10,6 +13,7 @@
 #include "webdatawidget/WebDataWidget.h"
 #include "wifiwidget/WifiWidget.h"
 #include <Arduino.h>
+#include <TJpg_Decoder.h>
 
 #ifdef STOCK_TICKER_LIST
     #include "stockwidget/StockWidget.h"
@@ -47,6 +51,21 @@ bool isConnected{true};
 ScreenManager *sm;
 WidgetSet *widgetSet;
 
+// Longest wait for the first NTP answer before the clock is shown anyway
+#ifndef NTP_SYNC_TIMEOUT
+    #define NTP_SYNC_TIMEOUT 3000
+#endif
+
+bool firstFrameDone{false};
+unsigned long bootStageStart{0};
+
+// Boot timeline, logs how long each startup stage took
+void logBootStage(const char *stage) {
+    unsigned long now = millis();
+    Serial.printf("Boot: %s took %lu ms (%lu ms since reset)\n", stage, now - bootStageStart, now);
+    bootStageStart = now;
+}
+
 // This function should probably be moved somewhere else
 bool tft_output(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t *bitmap) {
     if (y >= tft.height())
@@ -55,16 +74,25 @@ bool tft_output(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t *bitmap)
     for (int i = 0; i < w * h; i++) {
         bitmap[i] = Utils::rgb565dim(bitmap[i], sm->getBrightness(), true);
     }
-    tft.pushImage(x, y, w, h, bitmap);
+    sm->pushImage(x, y, w, h, bitmap);
     return 1;
 }
 
 /**
  * The ISR handlers must be static
  */
-void isrButtonChangeLeft() { buttonLeft.isrButtonChange(); }
-void isrButtonChangeMiddle() { buttonOK.isrButtonChange(); }
-void isrButtonChangeRight() { buttonRight.isrButtonChange(); }
+void isrButtonChangeLeft() {
+    buttonLeft.isrButtonChange();
+    Scheduler::wakeUpFromISR();
+}
+void isrButtonChangeMiddle() {
+    buttonOK.isrButtonChange();
+    Scheduler::wakeUpFromISR();
+}
+void isrButtonChangeRight() {
+    buttonRight.isrButtonChange();
+    Scheduler::wakeUpFromISR();
+}
 
 void setupButtons() {
     buttonLeft.begin();
@@ -76,17 +104,44 @@ void setupButtons() {
     attachInterrupt(digitalPinToInterrupt(BUTTON_RIGHT), isrButtonChangeRight, CHANGE);
 }
 
+#ifdef ASSET_STORE
+// Without the assets partition there are no fonts and images, tell the user with the built-in font and stop
+void showMissingAssets() {
+    const char *lines[NUM_SCREENS] = {"", "Assets missing,", "flash them with", "-t uploadassets", ""};
+    sm->setLegacyTextDatum(MC_DATUM);
+    sm->setLegacyTextColor(TFT_RED, TFT_BLACK);
+    for (int i = 0; i < NUM_SCREENS; i++) {
+        sm->selectScreen(i);
+        sm->drawLegacyString(lines[i], ScreenCenterX, ScreenCenterY, 4);
+    }
+    while (true) {
+        delay(1000);
+    }
+}
+#endif
+
 void setup() {
     Serial.begin(115200);
     Serial.println();
     Serial.println("Starting up...");
 
+#ifdef ASSET_STORE
+    bool assetsFound = AssetStore::begin();
+#endif
+
+    Scheduler::begin();
+
     TJpgDec.setSwapBytes(true); // JPEG rendering setup
     TJpgDec.setCallback(tft_output);
     setupButtons();
 
     sm = new ScreenManager(tft);
     sm->fillAllScreens(TFT_BLACK);
+#ifdef ASSET_STORE
+    if (!assetsFound) {
+        showMissingAssets();
+    }
+#endif
     sm->setFontColor(TFT_WHITE);
 
     sm->selectScreen(0);
@@ -101,8 +156,7 @@ void setup() {
 
     sm->selectScreen(2);
 
-    TJpgDec.setJpgScale(1);
-    TJpgDec.drawJpg(0, 0, logo_start, logo_end - logo_start);
+    sm->drawImage(0, 0, logo_start(), logo_end() - logo_start());
 
     widgetSet = new WidgetSet(sm);
 
@@ -114,10 +168,12 @@ void setup() {
 #endif
 
     pinMode(BUSY_PIN, OUTPUT);
+    logBootStage("Display");
     Serial.println("Connecting to WiFi");
 
     wifiWidget = new WifiWidget(*sm);
     wifiWidget->setup();
+    logBootStage("WiFi setup");
 
     globalTime = GlobalTime::getInstance();
 
@@ -140,6 +196,58 @@ void setup() {
 #endif
 
     m_widgetCycleDelayPrev = millis();
+    logBootStage("Widget setup");
+}
+
+// Wait for NTP, so the first frame of the clock doesn't show 1970.
+// The glyph prewarm continues meanwhile and is finished before the first frame.
+void waitForTimeSync() {
+    unsigned long start = millis();
+    while (time(nullptr) < 1700000000 && millis() - start < NTP_SYNC_TIMEOUT) {
+        if (!sm->prewarmGlyphCache()) {
+            delay(10);
+        }
+    }
+    if (time(nullptr) < 1700000000) {
+        Serial.println("No NTP answer yet, starting anyway");
+    }
+    while (sm->prewarmGlyphCache()) {
+    }
+}
+
+// Wake up once ms have passed since the last widget switch or button press, not at all when that's over
+void runAfterLastSwitch(unsigned long ms) {
+    unsigned long elapsed = millis() - m_widgetCycleDelayPrev;
+    if (elapsed < ms) {
+        Scheduler::runWithin(ms - elapsed);
+    }
+}
+
+// Sleep until the clock, the current widget or the widget cycling has something to do,
+// buttons and WiFi events wake up earlier
+void sleepUntilNextDeadline(bool blank) {
+    // Still needed when blank, e.g. MQTT has to keep its connection alive
+    Scheduler::runWithin(widgetSet->getCurrent()->getMillisToNextUpdate());
+    if (blank) {
+        // Only the end of the dim hours has to be noticed, nothing is drawn
+        Scheduler::runWithin((60 - globalTime->getSecond()) * 1000L);
+    } else {
+        Scheduler::runWithin(globalTime->getMillisToNextSecond());
+        if (m_widgetCycleDelay > 0) {
+            runAfterLastSwitch(m_widgetCycleDelay);
+            runAfterLastSwitch(m_widgetCycleDelay > WIDGET_PREFETCH_LEAD ? m_widgetCycleDelay - WIDGET_PREFETCH_LEAD : 0);
+        } else if (!widgetSet->isPrefetched(widgetSet->getLastDirection())) {
+            runAfterLastSwitch(WIDGET_PREFETCH_IDLE);
+        }
+#if WIDGET_PRERENDER
+        runAfterLastSwitch(m_widgetCycleDelay > WIDGET_PRERENDER_LEAD ? m_widgetCycleDelay - WIDGET_PRERENDER_LEAD : WIDGET_PRERENDER_IDLE);
+#endif
+    }
+    if (!widgetSet->initialUpdateDone()) {
+        // More widgets to initialize
+        Scheduler::runWithin(0);
+    }
+    Scheduler::sleep();
 }
 
 void checkCycleWidgets() {
@@ -149,49 +257,70 @@ void checkCycleWidgets() {
     }
 }
 
-void checkButtons() {
-    // Reset cycle timer whenever a button is pressed
-    if (buttonLeft.pressedShort()) {
-        // Left short press cycles widgets backward
-        Serial.println("Left button short pressed -> switch to prev Widget");
-        m_widgetCycleDelayPrev = millis();
-        widgetSet->prev();
-    } else if (buttonRight.pressedShort()) {
-        // Right short press cycles widgets forward
-        Serial.println("Right button short pressed -> switch to next Widget");
+void checkPrefetchNextWidget() {
+    unsigned long elapsed = millis() - m_widgetCycleDelayPrev;
+    if (m_widgetCycleDelay > 0 && elapsed + WIDGET_PREFETCH_LEAD >= m_widgetCycleDelay) {
+        // Auto-cycling always moves forward, keep the next widget fresh until it's shown
+        widgetSet->prefetch(1);
+    } else if (elapsed >= WIDGET_PREFETCH_IDLE && !widgetSet->isPrefetched(widgetSet->getLastDirection())) {
+        // Expect the user to keep browsing in the same direction
+        widgetSet->prefetch(widgetSet->getLastDirection());
+    }
+}
+
+void checkPrepareNextWidget() {
+    // When cycling, render the next widget shortly before it is due,
+    // otherwise as soon as nobody has pressed a button for a while
+    unsigned long prepareAfter = m_widgetCycleDelay > WIDGET_PRERENDER_LEAD ? m_widgetCycleDelay - WIDGET_PRERENDER_LEAD : WIDGET_PRERENDER_IDLE;
+    if (millis() - m_widgetCycleDelayPrev >= prepareAfter) {
+        widgetSet->prepareNext();
+    }
+}
+
+void handleButton(Button &button, uint8_t pin, const char *name) {
+    ButtonState state;
+    // Handle every queued press, so presses during a long draw are not lost
+    while ((state = button.getState()) != BTN_NOTHING) {
+        // Reset cycle timer whenever a button is pressed
         m_widgetCycleDelayPrev = millis();
-        widgetSet->next();
-    } else {
-        ButtonState leftState = buttonLeft.getState();
-        ButtonState middleState = buttonOK.getState();
-        ButtonState rightState = buttonRight.getState();
-
-        // Everying else that is not BTN_NOTHING will be forwarded to the current widget
-        if (leftState != BTN_NOTHING) {
-            Serial.printf("Left button pressed, state=%d\n", leftState);
-            m_widgetCycleDelayPrev = millis();
-            widgetSet->buttonPressed(BUTTON_LEFT, leftState);
-        } else if (middleState != BTN_NOTHING) {
-            Serial.printf("Middle button pressed, state=%d\n", middleState);
-            m_widgetCycleDelayPrev = millis();
-            widgetSet->buttonPressed(BUTTON_OK, middleState);
-        } else if (rightState != BTN_NOTHING) {
-            Serial.printf("Right button pressed, state=%d\n", rightState);
-            m_widgetCycleDelayPrev = millis();
-            widgetSet->buttonPressed(BUTTON_RIGHT, rightState);
+        Serial.printf("%s button pressed, state=%d, latency=%lu ms\n", name, state, millis() - button.getEventTime());
+        if (state == BTN_SHORT && pin == BUTTON_LEFT) {
+            // Left short press cycles widgets backward
+            widgetSet->prev();
+        } else if (state == BTN_SHORT && pin == BUTTON_RIGHT) {
+            // Right short press cycles widgets forward
+            widgetSet->next();
+        } else {
+            // Everying else will be forwarded to the current widget
+            widgetSet->buttonPressed(pin, state);
         }
     }
 }
 
+void checkButtons() {
+    handleButton(buttonLeft, BUTTON_LEFT, "Left");
+    handleButton(buttonOK, BUTTON_OK, "Middle");
+    handleButton(buttonRight, BUTTON_RIGHT, "Right");
+}
+
 void loop() {
     if (wifiWidget->isConnected() == false) {
         wifiWidget->update();
         wifiWidget->draw();
         widgetSet->setClearScreensOnDrawCurrent(); // Clear screen after wifiWidget
-        delay(100);
+        // Use the time waiting for WiFi to rasterize the glyphs the widgets registered
+        unsigned long waitStart = millis();
+        while (millis() - waitStart < 100 && sm->prewarmGlyphCache()) {
+        }
+        unsigned long waited = millis() - waitStart;
+        if (waited < 100) {
+            delay(100 - waited);
+        }
     } else {
-        if (!widgetSet->initialUpdateDone()) {
-            widgetSet->initializeAllWidgetsData();
+        if (!firstFrameDone) {
+            logBootStage("WiFi");
+            waitForTimeSync();
+            logBootStage("NTP");
         }
         globalTime->updateTime();
 
@@ -199,8 +328,29 @@ void loop() {
 
         widgetSet->updateCurrent();
         widgetSet->updateBrightnessByTime(globalTime->getHour24());
-        widgetSet->drawCurrent();
+        // DIM_BRIGHTNESS 0 blanks the screens, nothing is drawn until the dim hours are over
+        bool blank = sm->getBrightness() == 0;
+        if (!blank) {
+            widgetSet->drawCurrent();
+            sm->tuneGlyphCache();
+        }
+        if (!firstFrameDone) {
+            firstFrameDone = true;
+            logBootStage("First frame");
+        }
+
+        // The other widgets get their data in the background, one per loop
+        if (!widgetSet->initialUpdateDone() && !widgetSet->initializeNextWidget()) {
+            logBootStage("Widget data");
+        }
+
+        if (!blank) {
+            checkCycleWidgets();
+            checkPrefetchNextWidget();
+            checkPrepareNextWidget();
+        }
 
-        checkCycleWidgets();
+        Snapshot::getInstance()->writePending();
+        sleepUntilNextDeadline(blank);
     }
 }
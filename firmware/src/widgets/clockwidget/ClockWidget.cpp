@@ -13,6 +13,12 @@ void ClockWidget::setup() {
     m_lastDisplay2Digit = "";
     m_lastDisplay4Digit = "";
     m_lastDisplay5Digit = "";
+
+    // Digits, colon and shadow segments
+    m_manager.registerGlyphs(CLOCK_FONT, CLOCK_FONT_SIZE, "0123456789 :8#");
+    if (!FORMAT_24_HOUR && SHOW_AM_PM_INDICATOR) {
+        m_manager.registerGlyphs(CLOCK_FONT == TTF_Font::DSEG7 ? TTF_Font::DSEG14 : CLOCK_FONT, 25, "AMP");
+    }
 }
 
 void ClockWidget::draw(bool force) {
@@ -61,27 +67,22 @@ void ClockWidget::draw(bool force) {
 void ClockWidget::displayAmPm(String &amPm, uint32_t color) {
     m_manager.selectScreen(2);
     m_manager.setFontColor(color, TFT_BLACK);
-    // Workaround for 12h AM/PM problem
-    // The colon is slightly offset and that's a problem because to remove them, we paint over them
-    // I think this is related to the TTF cache
-    // The problem disappears if we reload the font here
     if (CLOCK_FONT == TTF_Font::DSEG7) {
-        // We set a new font anyway
+        // DSEG7 has no proper letters
         m_manager.setFont(TTF_Font::DSEG14);
-    } else {
-        // Force reloading the font
-        m_manager.setFont(TTF_Font::NONE);
-        m_manager.setFont(CLOCK_FONT);
     }
     m_manager.drawString(amPm, SCREEN_SIZE / 5 * 4, SCREEN_SIZE / 2, 25, Align::MiddleCenter);
 }
 
 void ClockWidget::update(bool force) {
-    if (millis() - m_secondTimerPrev < m_secondTimer && !force) {
+    if ((long) (millis() - m_nextTick) < 0 && !force) {
         return;
     }
 
     GlobalTime *time = GlobalTime::getInstance();
+    time->updateTime();
+    // Wake up just after the next second edge, so we never sample the old second
+    m_nextTick = millis() + time->getMillisToNextSecond() + 1;
 
     m_hourSingle = time->getHour();
     m_minuteSingle = time->getMinute();
@@ -104,15 +105,23 @@ void ClockWidget::update(bool force) {
     }
 
     if (m_lastMinuteSingle != m_minuteSingle || force) {
-        String currentMinutePadded = String(m_minuteSingle).length() == 1 ? "0" + String(m_minuteSingle) : String(m_minuteSingle);
+        const char *currentMinutePadded = time->getMinutePadded();
 
-        m_display4Digit = currentMinutePadded.substring(0, 1);
-        m_display5Digit = currentMinutePadded.substring(1, 2);
+        m_display4Digit = currentMinutePadded[0];
+        m_display5Digit = currentMinutePadded[1];
 
         m_lastMinuteSingle = m_minuteSingle;
     }
 }
 
+long ClockWidget::getMillisToNextUpdate() {
+    if (m_manager.getBrightness() == 0) {
+        // Blank screens don't show the seconds, the next minute is enough
+        return (60 - GlobalTime::getInstance()->getSecond()) * 1000L;
+    }
+    return (long) (m_nextTick - millis());
+}
+
 void ClockWidget::change24hMode() {
     GlobalTime *time = GlobalTime::getInstance();
     time->setFormat24Hour(!time->getFormat24Hour());
@@ -238,43 +247,42 @@ void ClockWidget::displayNixie(int displayIndex, const String &digit) {
         return;
     }
     m_manager.selectScreen(displayIndex);
-    TJpgDec.setJpgScale(1);
     switch (digit.charAt(0)) {
     case '0':
-        TJpgDec.drawJpg(0, 0, nixie_0_start, nixie_0_end - nixie_0_start);
+        m_manager.drawImage(0, 0, nixie_0_start(), nixie_0_end() - nixie_0_start());
         break;
     case '1':
-        TJpgDec.drawJpg(0, 0, nixie_1_start, nixie_1_end - nixie_1_start);
+        m_manager.drawImage(0, 0, nixie_1_start(), nixie_1_end() - nixie_1_start());
         break;
     case '2':
-        TJpgDec.drawJpg(0, 0, nixie_2_start, nixie_2_end - nixie_2_start);
+        m_manager.drawImage(0, 0, nixie_2_start(), nixie_2_end() - nixie_2_start());
         break;
     case '3':
-        TJpgDec.drawJpg(0, 0, nixie_3_start, nixie_3_end - nixie_3_start);
+        m_manager.drawImage(0, 0, nixie_3_start(), nixie_3_end() - nixie_3_start());
         break;
     case '4':
-        TJpgDec.drawJpg(0, 0, nixie_4_start, nixie_4_end - nixie_4_start);
+        m_manager.drawImage(0, 0, nixie_4_start(), nixie_4_end() - nixie_4_start());
         break;
     case '5':
-        TJpgDec.drawJpg(0, 0, nixie_5_start, nixie_5_end - nixie_5_start);
+        m_manager.drawImage(0, 0, nixie_5_start(), nixie_5_end() - nixie_5_start());
         break;
     case '6':
-        TJpgDec.drawJpg(0, 0, nixie_6_start, nixie_6_end - nixie_6_start);
+        m_manager.drawImage(0, 0, nixie_6_start(), nixie_6_end() - nixie_6_start());
         break;
     case '7':
-        TJpgDec.drawJpg(0, 0, nixie_7_start, nixie_7_end - nixie_7_start);
+        m_manager.drawImage(0, 0, nixie_7_start(), nixie_7_end() - nixie_7_start());
         break;
     case '8':
-        TJpgDec.drawJpg(0, 0, nixie_8_start, nixie_8_end - nixie_8_start);
+        m_manager.drawImage(0, 0, nixie_8_start(), nixie_8_end() - nixie_8_start());
         break;
     case '9':
-        TJpgDec.drawJpg(0, 0, nixie_9_start, nixie_9_end - nixie_9_start);
+        m_manager.drawImage(0, 0, nixie_9_start(), nixie_9_end() - nixie_9_start());
         break;
     case ' ':
-        TJpgDec.drawJpg(0, 0, nixie_colon_off_start, nixie_colon_off_end - nixie_colon_off_start);
+        m_manager.drawImage(0, 0, nixie_colon_off_start(), nixie_colon_off_end() - nixie_colon_off_start());
         break;
     case ':':
-        TJpgDec.drawJpg(0, 0, nixie_colon_on_start, nixie_colon_on_end - nixie_colon_on_start);
+        m_manager.drawImage(0, 0, nixie_colon_on_start(), nixie_colon_on_end() - nixie_colon_on_start());
         break;
     }
 #endif
@@ -286,43 +294,42 @@ void ClockWidget::displayCustom(int displayIndex, const String &digit) {
         return;
     }
     m_manager.selectScreen(displayIndex);
-    TJpgDec.setJpgScale(1);
     switch (digit.charAt(0)) {
     case '0':
-        TJpgDec.drawJpg(0, 0, clock_custom_0_start, clock_custom_0_end - clock_custom_0_start);
+        m_manager.drawImage(0, 0, clock_custom_0_start(), clock_custom_0_end() - clock_custom_0_start());
         break;
     case '1':
-        TJpgDec.drawJpg(0, 0, clock_custom_1_start, clock_custom_1_end - clock_custom_1_start);
+        m_manager.drawImage(0, 0, clock_custom_1_start(), clock_custom_1_end() - clock_custom_1_start());
         break;
     case '2':
-        TJpgDec.drawJpg(0, 0, clock_custom_2_start, clock_custom_2_end - clock_custom_2_start);
+        m_manager.drawImage(0, 0, clock_custom_2_start(), clock_custom_2_end() - clock_custom_2_start());
         break;
     case '3':
-        TJpgDec.drawJpg(0, 0, clock_custom_3_start, clock_custom_3_end - clock_custom_3_start);
+        m_manager.drawImage(0, 0, clock_custom_3_start(), clock_custom_3_end() - clock_custom_3_start());
         break;
     case '4':
-        TJpgDec.drawJpg(0, 0, clock_custom_4_start, clock_custom_4_end - clock_custom_4_start);
+        m_manager.drawImage(0, 0, clock_custom_4_start(), clock_custom_4_end() - clock_custom_4_start());
         break;
     case '5':
-        TJpgDec.drawJpg(0, 0, clock_custom_5_start, clock_custom_5_end - clock_custom_5_start);
+        m_manager.drawImage(0, 0, clock_custom_5_start(), clock_custom_5_end() - clock_custom_5_start());
         break;
     case '6':
-        TJpgDec.drawJpg(0, 0, clock_custom_6_start, clock_custom_6_end - clock_custom_6_start);
+        m_manager.drawImage(0, 0, clock_custom_6_start(), clock_custom_6_end() - clock_custom_6_start());
         break;
     case '7':
-        TJpgDec.drawJpg(0, 0, clock_custom_7_start, clock_custom_7_end - clock_custom_7_start);
+        m_manager.drawImage(0, 0, clock_custom_7_start(), clock_custom_7_end() - clock_custom_7_start());
         break;
     case '8':
-        TJpgDec.drawJpg(0, 0, clock_custom_8_start, clock_custom_8_end - clock_custom_8_start);
+        m_manager.drawImage(0, 0, clock_custom_8_start(), clock_custom_8_end() - clock_custom_8_start());
         break;
     case '9':
-        TJpgDec.drawJpg(0, 0, clock_custom_9_start, clock_custom_9_end - clock_custom_9_start);
+        m_manager.drawImage(0, 0, clock_custom_9_start(), clock_custom_9_end() - clock_custom_9_start());
         break;
     case ' ':
-        TJpgDec.drawJpg(0, 0, clock_custom_colon_off_start, clock_custom_colon_off_end - clock_custom_colon_off_start);
+        m_manager.drawImage(0, 0, clock_custom_colon_off_start(), clock_custom_colon_off_end() - clock_custom_colon_off_start());
         break;
     case ':':
-        TJpgDec.drawJpg(0, 0, clock_custom_colon_on_start, clock_custom_colon_on_end - clock_custom_colon_on_start);
+        m_manager.drawImage(0, 0, clock_custom_colon_on_start(), clock_custom_colon_on_end() - clock_custom_colon_on_start());
         break;
     }
 #endif
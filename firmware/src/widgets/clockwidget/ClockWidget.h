@@ -3,7 +3,6 @@
 
 #include "GlobalTime.h"
 #include "Widget.h"
-#include <TJpg_Decoder.h>
 
 #ifndef USE_CLOCK_NIXIE
     #define USE_CLOCK_NIXIE true
@@ -80,6 +79,7 @@ public:
     ~ClockWidget() override;
     void setup() override;
     void update(bool force = false) override;
+    long getMillisToNextUpdate() override;
     void draw(bool force = false) override;
     void buttonPressed(uint8_t buttonId, ButtonState state) override;
     String getName() override;
@@ -102,8 +102,7 @@ private:
     int m_timeZoneOffset;
 
     // Delays for setting how often certain screens/functions are refreshed/checked. These include both the frequency which they need to be checked and a varibale to store the last checked value.
-    unsigned long m_secondTimer = 2000; // This time is used to refressh/check the clock every second.
-    unsigned long m_secondTimerPrev = 0;
+    unsigned long m_nextTick = 0; // millis() of the next second edge, the clock is refreshed exactly then
 
     int m_minuteSingle;
     int m_hourSingle;
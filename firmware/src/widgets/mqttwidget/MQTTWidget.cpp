@@ -2,6 +2,8 @@
 
     #include "MQTTWidget.h"
 
+    #define MQTT_SNAPSHOT_VERSION 1
+
 // Initialize the static instance pointer
 MQTTWidget *MQTTWidget::instance = nullptr;
 
@@ -25,6 +27,8 @@ MQTTWidget::MQTTWidget(ScreenManager &manager, const String &host, uint16_t port
 
     // Set the static callback proxy
     mqttClient.setCallback(staticCallback);
+
+    restoreSnapshot();
 }
 
 // Helper function to map color strings to uint16_t color values
@@ -109,6 +113,10 @@ void MQTTWidget::update(bool force) {
     mqttClient.loop(); // Process incoming MQTT messages
 }
 
+long MQTTWidget::getMillisToNextUpdate() {
+    return MQTT_POLL_INTERVAL;
+}
+
 // Draw method: Draws all orbs (can be used for initial drawing or full refresh)
 void MQTTWidget::draw(bool force) {
     m_manager.setFont(DEFAULT_FONT);
@@ -219,6 +227,7 @@ void MQTTWidget::callback(char *topic, byte *payload, unsigned int length) {
 
                             // Redraw the orb with updated data
                             drawOrb(orb->orbid);
+                            saveSnapshot();
                         } else {
                             Serial.println("No change detected for field: " + orb->jsonField);
                         }
@@ -232,6 +241,7 @@ void MQTTWidget::callback(char *topic, byte *payload, unsigned int length) {
                         it->second = message;
                         Serial.println("Updated data for " + receivedTopic + ": " + message);
                         drawOrb(orb->orbid);
+                        saveSnapshot();
                     } else {
                         Serial.println("No change detected for topic: " + receivedTopic);
                     }
@@ -249,6 +259,20 @@ void MQTTWidget::callback(char *topic, byte *payload, unsigned int length) {
 void MQTTWidget::handleSetupMessage(const String &message) {
     //    Serial.println("Handling setup message...");
 
+    if (!parseSetupMessage(message)) {
+        return;
+    }
+    setupMessage = message;
+    saveSnapshot();
+
+    // Subscribe to all configured topics
+    subscribeToOrbs();
+
+    // Trigger a redraw to display the configured orbs
+    draw(true);
+}
+
+bool MQTTWidget::parseSetupMessage(const String &message) {
     // Parse JSON configuration
     JsonDocument doc;
     DeserializationError error = deserializeJson(doc, message);
@@ -256,7 +280,7 @@ void MQTTWidget::handleSetupMessage(const String &message) {
     if (error) {
         Serial.print("Failed to parse setup JSON: ");
         Serial.println(error.c_str());
-        return;
+        return false;
     }
 
     // Clear existing configurations and data
@@ -296,12 +320,48 @@ void MQTTWidget::handleSetupMessage(const String &message) {
         // Initialize data map with empty strings
         orbDataMap[config.topicSrc] = "";
     }
+    return true;
+}
 
-    // Subscribe to all configured topics
-    subscribeToOrbs();
+// Configure the orbs from the last setup message and show the last values until the broker sends new ones
+void MQTTWidget::restoreSnapshot() {
+    SnapshotReader in;
+    if (!Snapshot::getInstance()->restore("mqtt", MQTT_SNAPSHOT_VERSION, in)) {
+        return;
+    }
+    String message = in.readString();
+    if (!in.ok() || !parseSetupMessage(message)) {
+        return;
+    }
+    setupMessage = message;
+    int count = in.readU16();
+    for (int i = 0; i < count && in.ok(); i++) {
+        String topic = in.readString();
+        String value = in.readString();
+        if (!in.ok() || orbDataMap.find(topic) == orbDataMap.end()) {
+            continue;
+        }
+        orbDataMap[topic] = value;
+        for (auto &orb : orbConfigs) {
+            if (orb.topicSrc.equals(topic) && orb.jsonField.length() > 0) {
+                orb.lastValuesMap[orb.jsonField] = value;
+            }
+        }
+    }
+}
 
-    // Trigger a redraw to display the configured orbs
-    draw(true);
+void MQTTWidget::saveSnapshot() {
+    if (setupMessage.length() == 0) {
+        return;
+    }
+    SnapshotWriter out;
+    out.writeString(setupMessage);
+    out.writeU16(orbDataMap.size());
+    for (const auto &data : orbDataMap) {
+        out.writeString(data.first);
+        out.writeString(data.second);
+    }
+    Snapshot::getInstance()->save("mqtt", MQTT_SNAPSHOT_VERSION, out);
 }
 
 // Subscribe to all orb topics
@@ -1,6 +1,7 @@
 #ifndef MQTT_WIDGET_H
 #define MQTT_WIDGET_H
 
+#include "Snapshot.h"
 #include "Utils.h"
 #include "Widget.h"
 #include <ArduinoJson.h>
@@ -9,6 +10,11 @@
 #include <map>
 #include <vector>
 
+// Incoming messages don't wake up the main loop, poll the client at least this often
+#ifndef MQTT_POLL_INTERVAL
+    #define MQTT_POLL_INTERVAL 50
+#endif
+
 // Structure to hold individual orb configurations
 struct OrbConfig {
     int orbid; // Orb identifier
@@ -56,6 +62,11 @@ public:
      */
     void draw(bool force = false) override;
 
+    /**
+     * @brief Messages are only received while polling, so the main loop may not sleep for long.
+     */
+    long getMillisToNextUpdate() override;
+
     /**
      * @brief Handles mode changes (if applicable).
      */
@@ -77,6 +88,9 @@ private:
     // Data storage: maps topicSrc to latest message
     std::map<String, String> orbDataMap;
 
+    // Last setup message, kept for the snapshot
+    String setupMessage;
+
     // Static callback proxy
     static void staticCallback(char *topic, byte *payload, unsigned int length);
 
@@ -87,6 +101,9 @@ private:
     void reconnect(); // Handle MQTT reconnection
     void callback(char *topic, byte *payload, unsigned int length); // MQTT message callback
     void handleSetupMessage(const String &message); // Process setup JSON
+    bool parseSetupMessage(const String &message); // Configure the orbs from setup JSON
+    void restoreSnapshot(); // Last known orbs and values
+    void saveSnapshot();
     void subscribeToOrbs(); // Subscribe to all configured orb topics
     uint16_t getColorFromString(const String &colorStr); // Convert color string to uint16_t
     void drawOrb(int orbid); // Draw a single orb based on orbid
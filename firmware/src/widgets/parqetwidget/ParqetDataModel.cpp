@@ -87,4 +87,39 @@ void ParqetDataModel::getChartDataScale(uint8_t maxY, float &scale, float &minVa
     minVal = _minVal;
     maxVal = _maxVal;
     chartMinVal = min(_minVal, zero);
-}
\ No newline at end of file
+}
+
+void ParqetDataModel::save(SnapshotWriter &out) {
+    out.writeU16(m_holdingsCount);
+    for (int i = 0; i < m_holdingsCount; i++) {
+        m_holdings[i].save(out);
+    }
+    out.writeU16(m_chartdataCount);
+    for (int i = 0; i < m_chartdataCount; i++) {
+        out.writeFloat(m_chartdata[i]);
+    }
+}
+
+bool ParqetDataModel::load(SnapshotReader &in) {
+    int holdingsCount = in.readU16();
+    // Every holding needs at least 26 bytes, don't trust a count that can't be there
+    if (holdingsCount * 26 > in.remaining()) {
+        return false;
+    }
+    ParqetHoldingDataModel *holdings = new ParqetHoldingDataModel[holdingsCount];
+    for (int i = 0; i < holdingsCount; i++) {
+        holdings[i].load(in);
+    }
+    int chartCount = in.readU16();
+    if (!in.ok() || chartCount * sizeof(float) != in.remaining()) {
+        delete[] holdings;
+        return false;
+    }
+    float *chart = new float[chartCount];
+    for (int i = 0; i < chartCount; i++) {
+        chart[i] = in.readFloat();
+    }
+    setHoldings(holdings, holdingsCount);
+    setChartData(chart, chartCount);
+    return true;
+}
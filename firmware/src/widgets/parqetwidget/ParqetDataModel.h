@@ -20,6 +20,10 @@ public:
     int getChartDataCount();
     void getChartDataScale(uint8_t maxY, float &scale, float &minVal, float &maxVal, float &chartMinVal);
 
+    // Holdings and chart, the portfolio id is configured
+    void save(SnapshotWriter &out);
+    bool load(SnapshotReader &in);
+
 private:
     String m_portfolioId = "";
     ParqetHoldingDataModel *m_holdings = nullptr;
@@ -66,4 +66,27 @@ String ParqetHoldingDataModel::getPercentChange(int8_t digits) {
 }
 String ParqetHoldingDataModel::getCurrency() {
     return m_currency;
-}
\ No newline at end of file
+}
+
+void ParqetHoldingDataModel::save(SnapshotWriter &out) {
+    out.writeString(m_id);
+    out.writeString(m_name);
+    out.writeFloat(m_purchasePrice);
+    out.writeFloat(m_purchaseValue);
+    out.writeFloat(m_currentPrice);
+    out.writeFloat(m_currentValue);
+    out.writeFloat(m_shares);
+    out.writeString(m_currency);
+}
+
+bool ParqetHoldingDataModel::load(SnapshotReader &in) {
+    m_id = in.readString();
+    m_name = in.readString();
+    m_purchasePrice = in.readFloat();
+    m_purchaseValue = in.readFloat();
+    m_currentPrice = in.readFloat();
+    m_currentValue = in.readFloat();
+    m_shares = in.readFloat();
+    m_currency = in.readString();
+    return in.ok();
+}
@@ -1,6 +1,7 @@
 #ifndef PARQET_HOLDING_DATA_MODEL_H
 #define PARQET_HOLDING_DATA_MODEL_H
 
+#include "Snapshot.h"
 #include <Arduino.h>
 
 #include <iomanip>
@@ -31,6 +32,9 @@ public:
     String getPercentChange(int8_t digits);
     String getCurrency();
 
+    void save(SnapshotWriter &out);
+    bool load(SnapshotReader &in);
+
 private:
     String m_id = "";
     String m_name = "";
@@ -7,6 +7,9 @@
 
 #include <iomanip>
 
+#define PARQET_SNAPSHOT_VERSION 1
+#define PARQET_API_HOST "api.parqet.com"
+
 ParqetWidget::ParqetWidget(ScreenManager &manager) : Widget(manager) {
     Serial.println("Constructing ParqetWidget");
     ParqetDataModel parqet = ParqetDataModel();
@@ -14,6 +17,7 @@ ParqetWidget::ParqetWidget(ScreenManager &manager) : Widget(manager) {
     parqet.setPortfolioId(PARQET_PORTFOLIO_ID);
 #endif
     m_portfolio = parqet;
+    restoreSnapshot();
 }
 
 void ParqetWidget::setup() {
@@ -27,8 +31,9 @@ void ParqetWidget::draw(bool force) {
     bool isMultiPage = m_portfolio.getHoldingsCount() > (m_showClock ? 4 : 5);
     // Do we need to update the screens because cycle time is expired
     bool updateByCycle = isMultiPage && (millis() - m_cycleDelayPrev) >= m_cycleDelay;
-    // Do we need to update the clock screen?
-    bool updateByClock = m_showClock && (millis() - m_clockDelayPrev) >= m_clockDelay;
+    // Do we need to update the clock screen? It also shows when the data is stale
+    bool stale = m_refresh.isStale();
+    bool updateByClock = m_showClock && ((millis() - m_clockDelayPrev) >= m_clockDelay || stale != m_stale);
     // Do we need to update the stock screens?
     bool updateStocks = force || m_changed || updateByCycle;
     if (updateStocks || updateByClock) {
@@ -42,10 +47,15 @@ void ParqetWidget::draw(bool force) {
             int8_t totalPages = (m_portfolio.getHoldingsCount() - 1) / stockDisplays + 1;
             String extra = String(curPage) + "/" + String(totalPages);
             displayClock(0, TFT_BLACK, TFT_WHITE, extra, TFT_DARKGREY);
+            if (stale) {
+                drawStaleIndicator(0);
+            }
+            m_stale = stale;
             m_clockDelayPrev = millis();
         }
         if (updateStocks) {
             // Update the stocks only if necessary
+            uint8_t emptyScreens = 0;
             for (int8_t i = 0; i < stockDisplays; i++) {
                 int8_t displayIdx = startDisplay + i;
                 int8_t holdingIdx = m_holdingsDisplayFrom + i;
@@ -53,9 +63,13 @@ void ParqetWidget::draw(bool force) {
                     ParqetHoldingDataModel holding = m_portfolio.getHolding(holdingIdx);
                     displayStock(displayIdx, holding, TFT_BLACK, TFT_WHITE);
                 } else {
-                    clearScreen(displayIdx, TFT_BLACK);
+                    emptyScreens |= SCREEN_MASK(displayIdx);
                 }
             }
+            if (emptyScreens) {
+                // Clear all unused screens at once
+                clearScreens(emptyScreens, TFT_BLACK);
+            }
             // In the next cycle, show the next set of stocks
             m_holdingsDisplayFrom += stockDisplays;
             if (m_holdingsDisplayFrom >= m_portfolio.getHoldingsCount()) {
@@ -69,21 +83,51 @@ void ParqetWidget::draw(bool force) {
 }
 
 void ParqetWidget::update(bool force) {
-    if (force || m_stockDelayPrev == 0 || (millis() - m_stockDelayPrev) >= m_stockDelay) {
+    // Also forced updates wait for the backoff after failures
+    if ((force || m_refresh.isDue(isVisible())) && EndpointHealth::getInstance()->allow(PARQET_API_HOST)) {
         setBusy(true);
         Serial.println("Update ParqetPortfolio");
-        if (m_everDrawn && m_showClock) {
+        if (m_everDrawn && m_showClock && !m_prefetching) {
             displayClock(0, TFT_BLACK, TFT_WHITE, "Updating", TFT_RED);
         }
-        updatePortfolio();
-        updatePortfolioChart();
+        bool success = updatePortfolio();
+        if (success) {
+            EndpointHealth::getInstance()->success(PARQET_API_HOST);
+            updatePortfolioChart();
+            saveSnapshot();
+            SnapshotWriter data;
+            m_portfolio.save(data);
+            m_refresh.fetched(data.getChecksum());
+        } else {
+            // No chart request, it would wait for the same timeout
+            EndpointHealth::getInstance()->failure(PARQET_API_HOST);
+            m_refresh.failed(true);
+        }
         m_holdingsDisplayFrom = 0;
         m_changed = true;
         setBusy(false);
-        m_stockDelayPrev = millis();
     }
 }
 
+void ParqetWidget::prefetch() {
+    // We're not visible yet, so don't show the update status on the clock screen
+    m_prefetching = true;
+    update();
+    m_prefetching = false;
+}
+
+// Next fetch, page cycle or clock refresh
+long ParqetWidget::getMillisToNextUpdate() {
+    long next = max(m_refresh.getMillisToNext(isVisible()), EndpointHealth::getInstance()->getMillisToRetry(PARQET_API_HOST));
+    if (m_portfolio.getHoldingsCount() > (m_showClock ? 4 : 5)) {
+        next = min(next, (long) m_cycleDelay - (long) (millis() - m_cycleDelayPrev));
+    }
+    if (m_showClock) {
+        next = min(next, (long) m_clockDelay - (long) (millis() - m_clockDelayPrev));
+    }
+    return next;
+}
+
 void ParqetWidget::buttonPressed(uint8_t buttonId, ButtonState state) {
     if (buttonId == BUTTON_OK && state == BTN_SHORT) {
         // Force drawing to show the next set of stocks
@@ -110,17 +154,20 @@ ParqetDataModel ParqetWidget::getPortfolio() {
     return m_portfolio;
 }
 
-void ParqetWidget::updatePortfolio() {
+bool ParqetWidget::updatePortfolio() {
+    bool success = false;
     String portfolioId = m_portfolio.getPortfolioId();
     Serial.printf("Parqet: Update Portfolio %s\n", portfolioId.c_str());
     String httpRequestAddress = "https://api.parqet.com/v1/portfolios/assemble";
     String postPayload = "{ \"portfolioIds\": [\"" + portfolioId + "\"], \"holdingIds\": [], \"assetTypes\": [], \"timeframe\": \"" + getTimeframe() + "\"}";
     Serial.printf("POST Payload: %s\n", postPayload.c_str());
     HTTPClient http;
+    InflateStream body;
     const char *keys[] = {"Transfer-Encoding"};
     http.collectHeaders(keys, 1);
     http.begin(httpRequestAddress);
     http.addHeader("Content-Type", "application/json");
+    body.prepare(http);
 
     int httpCode = http.POST(postPayload);
     Serial.printf("HTTP %d, Size %d\n", httpCode, http.getSize());
@@ -142,7 +189,8 @@ void ParqetWidget::updatePortfolio() {
         filter["holdings"] = true;
         filter["performance"] = true;
 
-        DeserializationError error = deserializeJson(doc, response, DeserializationOption::Filter(filter));
+        body.begin(response);
+        DeserializationError error = deserializeJson(doc, body, DeserializationOption::Filter(filter));
 
         if (!error) {
             JsonArray holdings = doc["holdings"];
@@ -201,6 +249,7 @@ void ParqetWidget::updatePortfolio() {
                 holdingArray[count++] = h;
             }
             m_portfolio.setHoldings(holdingArray, count);
+            success = true;
         } else {
             // Handle JSON deserialization error
             Serial.println("deserializeJson() failed");
@@ -212,6 +261,29 @@ void ParqetWidget::updatePortfolio() {
     }
 
     http.end();
+    return success;
+}
+
+// Show the last known portfolio until the first fetch is done
+void ParqetWidget::restoreSnapshot() {
+    SnapshotReader in;
+    if (!Snapshot::getInstance()->restore("parqet", PARQET_SNAPSHOT_VERSION, in)) {
+        return;
+    }
+    if (in.readString() == m_portfolio.getPortfolioId() && m_portfolio.load(in)) {
+        m_changed = true;
+    }
+}
+
+// Only the default timeframe, that's what is shown after a reboot
+void ParqetWidget::saveSnapshot() {
+    if (m_curMode != 0 || m_portfolio.getHoldingsCount() == 0) {
+        return;
+    }
+    SnapshotWriter out;
+    out.writeString(m_portfolio.getPortfolioId());
+    m_portfolio.save(out);
+    Snapshot::getInstance()->save("parqet", PARQET_SNAPSHOT_VERSION, out);
 }
 
 void ParqetWidget::updatePortfolioChart() {
@@ -231,10 +303,12 @@ void ParqetWidget::updatePortfolioChart() {
     String postPayload = "{ \"portfolioIds\": [\"" + portfolioId + "\"], \"holdingIds\": [], \"assetTypes\": [], \"perfChartConfig\": [\"u\"], \"timeframe\": \"" + timeframe + "\"}";
     Serial.printf("POST Payload: %s\n", postPayload.c_str());
     HTTPClient http;
+    InflateStream body;
     const char *keys[] = {"Transfer-Encoding"};
     http.collectHeaders(keys, 1);
     http.begin(httpRequestAddress);
     http.addHeader("Content-Type", "application/json");
+    body.prepare(http);
 
     int httpCode = http.POST(postPayload);
     Serial.printf("HTTP %d, Size %d\n", httpCode, http.getSize());
@@ -254,7 +328,8 @@ void ParqetWidget::updatePortfolioChart() {
         JsonDocument filter;
         // Filter the response to save memory
         filter["charts"][0]["values"]["perfHistory"] = true;
-        DeserializationError error = deserializeJson(doc, response, DeserializationOption::Filter(filter));
+        body.begin(response);
+        DeserializationError error = deserializeJson(doc, body, DeserializationOption::Filter(filter));
 
         if (!error) {
             JsonArray charts = doc["charts"];
@@ -286,8 +361,8 @@ void ParqetWidget::updatePortfolioChart() {
     http.end();
 }
 
-void ParqetWidget::clearScreen(int8_t displayIndex, int32_t background) {
-    m_manager.selectScreen(displayIndex);
+void ParqetWidget::clearScreens(uint8_t screenMask, int32_t background) {
+    m_manager.selectScreens(screenMask);
     m_manager.fillScreen(background);
 }
 
@@ -387,18 +462,26 @@ void ParqetWidget::displayStock(int8_t displayIndex, ParqetHoldingDataModel &sto
         }
     } else {
         // Draw stock data (multiline)
-        String wrappedLines[MAX_WRAPPED_LINES];
-        String dataValues = stock.getName();
+        const char *wrappedLines[MAX_WRAPPED_LINES];
+        char name[128];
         int yOffset = 100;
-        int lineCount = Utils::getWrappedLines(wrappedLines, dataValues, 14);
+        int lineCount = 0;
+        int fontSize = 0;
+        // Use the largest font that fits the name on as few lines as possible (measurements are cached, so this is cheap)
+        for (int maxLines = 1; maxLines <= PARQET_MAX_STOCKNAME_LINES; maxLines++) {
+            strlcpy(name, stock.getName().c_str(), sizeof(name));
+            fontSize = 17 + 6 / maxLines;
+            lineCount = m_manager.wrapText(name, 200, fontSize, wrappedLines, MAX_WRAPPED_LINES);
+            if (lineCount <= maxLines) {
+                break;
+            }
+        }
         if (lineCount > PARQET_MAX_STOCKNAME_LINES) {
             lineCount = PARQET_MAX_STOCKNAME_LINES;
         }
         int height = 30;
         yOffset += (PARQET_MAX_STOCKNAME_LINES - lineCount) * height / 2;
         for (int i = 0; i < lineCount; i++) {
-            // Lager font if we need less lines
-            int fontSize = 17 + 6 / lineCount;
             m_manager.drawString(wrappedLines[i], 120, yOffset + (height * i), fontSize, Align::MiddleCenter);
         }
     }
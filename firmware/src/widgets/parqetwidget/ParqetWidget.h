@@ -1,12 +1,15 @@
 #ifndef PARQET_WIDGET_H
 #define PARQET_WIDGET_H
 
+#include "EndpointHealth.h"
 #include "GlobalTime.h"
+#include "InflateStream.h"
 #include <ArduinoJson.h>
 #include <HTTPClient.h>
 #include <TFT_eSPI.h>
 
 #include "ParqetDataModel.h"
+#include "RefreshPolicy.h"
 #include "Utils.h"
 #include "Widget.h"
 
@@ -19,22 +22,25 @@ public:
     void setup() override;
     void update(bool force = false) override;
     void draw(bool force = false) override;
+    void prefetch() override;
+    long getMillisToNextUpdate() override;
     void buttonPressed(uint8_t buttonId, ButtonState state) override;
     String getName() override;
 
 private:
     String getTimeframe();
-    void updatePortfolio();
+    bool updatePortfolio();
     void updatePortfolioChart();
+    void restoreSnapshot();
+    void saveSnapshot();
     void displayStock(int8_t displayIndex, ParqetHoldingDataModel &stock, uint32_t backgroundColor, uint32_t textColor);
     ParqetDataModel getPortfolio();
-    void clearScreen(int8_t displayIndex, int32_t background);
+    void clearScreens(uint8_t screenMask, int32_t background);
     void displayClock(int8_t displayIndex, uint32_t background, uint32_t color, String extra, uint32_t extraColor);
 
     GlobalTime *m_time;
 
-    unsigned long m_stockDelay = 15 * 60 * 1000; // default to 15m between updates
-    unsigned long m_stockDelayPrev = 0;
+    RefreshPolicy m_refresh{15 * 60 * 1000, true}; // default to 15m between updates, only during trading hours
 
     unsigned long m_cycleDelay = 30 * 1000; // cycle through pages (for more than 4/5 stocks) every 30 seconds
     unsigned long m_cycleDelayPrev = 0;
@@ -55,6 +61,8 @@ private:
     ParqetDataModel m_portfolio;
     int m_holdingsDisplayFrom = 0;
     boolean m_changed = false;
+    boolean m_stale = false; // Stale indicator is on the clock screen
     boolean m_everDrawn = false; // Track if our widget was ever drawn (to distinguish between an onboot and an onwidget update)
+    boolean m_prefetching = false; // Update was triggered by prefetch() while another widget is shown
 };
 #endif // PARQET_WIDGET_H
@@ -138,3 +138,27 @@ StockDataModel &StockDataModel::setChangedStatus(bool changed) {
     m_changed = changed;
     return *this;
 }
+
+void StockDataModel::save(SnapshotWriter &out) {
+    out.writeString(m_ticker);
+    out.writeString(m_company);
+    out.writeString(m_currencySymbol);
+    out.writeFloat(m_currentPrice);
+    out.writeFloat(m_highPrice);
+    out.writeFloat(m_lowPrice);
+    out.writeFloat(m_priceChange);
+    out.writeFloat(m_percentChange);
+}
+
+bool StockDataModel::load(SnapshotReader &in) {
+    m_ticker = in.readString();
+    m_company = in.readString();
+    m_currencySymbol = in.readString();
+    m_currentPrice = in.readFloat();
+    m_highPrice = in.readFloat();
+    m_lowPrice = in.readFloat();
+    m_priceChange = in.readFloat();
+    m_percentChange = in.readFloat();
+    m_changed = true;
+    return in.ok();
+}
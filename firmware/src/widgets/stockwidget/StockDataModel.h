@@ -1,6 +1,7 @@
 #ifndef STOCK_DATA_MODEL_H
 #define STOCK_DATA_MODEL_H
 
+#include "Snapshot.h"
 #include <Arduino.h>
 
 #include <iomanip>
@@ -34,6 +35,10 @@ public:
     bool isChanged();
     StockDataModel &setChangedStatus(bool changed);
 
+    // The symbol is configured, it's not part of the snapshot
+    void save(SnapshotWriter &out);
+    bool load(SnapshotReader &in);
+
 private:
     String m_symbol = "";
     String m_ticker = "";
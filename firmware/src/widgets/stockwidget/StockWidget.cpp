@@ -4,8 +4,16 @@
 #include <ArduinoJson.h>
 #include <HTTPClient.h>
 
+#include <climits>
 #include <iomanip>
 
+#define STOCK_SNAPSHOT_VERSION 1
+
+// Currency pairs (crypto and forex, e.g. BTC/USD) trade around the clock, the other symbols on the exchange
+static bool isPair(StockDataModel &stock) {
+    return stock.getSymbol().indexOf('/') >= 0;
+}
+
 StockWidget::StockWidget(ScreenManager &manager) : Widget(manager) {
 #ifdef STOCK_TICKER_LIST
     char stockList[strlen(STOCK_TICKER_LIST) + 1];
@@ -23,6 +31,7 @@ StockWidget::StockWidget(ScreenManager &manager) : Widget(manager) {
             break;
         }
     } while (symbol = strtok(nullptr, ","));
+    restoreSnapshot();
 #endif
 }
 
@@ -31,29 +40,98 @@ void StockWidget::setup() {
         Serial.println("No stock tickers available");
         return;
     }
+    // Fixed texts and prices for the glyph cache prewarm
+    m_manager.registerGlyphs(DEFAULT_FONT, 11, "52 Week:HL0123456789.,$");
+    m_manager.registerGlyphs(DEFAULT_FONT, 29, "0123456789.,%-$");
+    for (int8_t i = 0; i < m_stockCount; i++) {
+        m_manager.registerGlyphs(DEFAULT_FONT, 29, m_stocks[i].getSymbol().c_str());
+    }
 }
 
 void StockWidget::draw(bool force) {
     m_manager.setFont(DEFAULT_FONT);
     for (int8_t i = 0; i < m_stockCount; i++) {
-        if (m_stocks[i].isChanged() || force) {
+        bool stale = (isPair(m_stocks[i]) ? m_refresh : m_marketRefresh).isStale();
+        if (m_stocks[i].isChanged() || force || stale != m_stale[i]) {
             displayStock(i, m_stocks[i], TFT_WHITE, TFT_BLACK);
+            if (stale) {
+                drawStaleIndicator(i);
+            }
+            m_stale[i] = stale;
             m_stocks[i].setChangedStatus(false);
         }
     }
 }
 
 void StockWidget::update(bool force) {
-    if (force || m_stockDelayPrev == 0 || (millis() - m_stockDelayPrev) >= m_stockDelay) {
+    bool fetched = false;
+    if (isFetchDue(m_refresh, true, force)) {
         setBusy(true);
-        for (int8_t i = 0; i < m_stockCount; i++) {
-            getStockData(m_stocks[i]);
-        }
+        fetchStocks(m_refresh, true);
+        fetched = true;
+    }
+    // Checked after the pairs, they might have used the credits
+    if (isFetchDue(m_marketRefresh, false, force)) {
+        setBusy(true);
+        fetchStocks(m_marketRefresh, false);
+        fetched = true;
+    }
+    if (fetched) {
+        saveSnapshot();
         setBusy(false);
-        m_stockDelayPrev = millis();
     }
 }
 
+// Every symbol costs a credit, a group is only fetched when there are enough for all of them.
+// Also forced fetches wait for the quota and the backoff after failures. Empty groups are never fetched.
+bool StockWidget::isFetchDue(RefreshPolicy &policy, bool pairs, bool force) {
+    return countStocks(pairs) > 0 && (force || policy.isDue(isVisible())) && ApiQuota::getInstance()->getMillisToAvailable(QUOTA_HOST_TWELVEDATA, countStocks(pairs)) == 0 &&
+           EndpointHealth::getInstance()->allow(QUOTA_HOST_TWELVEDATA);
+}
+
+uint8_t StockWidget::countStocks(bool pairs) {
+    uint8_t count = 0;
+    for (int8_t i = 0; i < m_stockCount; i++) {
+        if (isPair(m_stocks[i]) == pairs) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void StockWidget::fetchStocks(RefreshPolicy &policy, bool pairs) {
+    SnapshotWriter data;
+    bool success = false;
+    for (int8_t i = 0; i < m_stockCount; i++) {
+        if (isPair(m_stocks[i]) == pairs) {
+            success |= getStockData(m_stocks[i]);
+            m_stocks[i].save(data);
+        }
+    }
+    if (success) {
+        policy.fetched(data.getChecksum());
+    } else {
+        // Invalid symbols or an invalid key are answered normally, only retry early when the server is down
+        policy.failed(EndpointHealth::getInstance()->getMillisToRetry(QUOTA_HOST_TWELVEDATA) > 0);
+    }
+}
+
+void StockWidget::prefetch() {
+    update();
+}
+
+long StockWidget::getMillisToNextUpdate() {
+    return min(getMillisToNextFetch(m_refresh, true), getMillisToNextFetch(m_marketRefresh, false));
+}
+
+long StockWidget::getMillisToNextFetch(RefreshPolicy &policy, bool pairs) {
+    if (countStocks(pairs) == 0) {
+        return LONG_MAX;
+    }
+    long next = max(policy.getMillisToNext(isVisible()), ApiQuota::getInstance()->getMillisToAvailable(QUOTA_HOST_TWELVEDATA, countStocks(pairs)));
+    return max(next, EndpointHealth::getInstance()->getMillisToRetry(QUOTA_HOST_TWELVEDATA));
+}
+
 void StockWidget::changeMode() {
     update(true);
 }
@@ -63,19 +141,29 @@ void StockWidget::buttonPressed(uint8_t buttonId, ButtonState state) {
         changeMode();
 }
 
-void StockWidget::getStockData(StockDataModel &stock) {
+bool StockWidget::getStockData(StockDataModel &stock) {
+    bool success = false;
     String httpRequestAddress = "https://api.twelvedata.com/quote?apikey=e03fc53524454ab8b65d91b23c669cc5&symbol=" + stock.getSymbol();
 
     HTTPClient http;
-    http.begin(httpRequestAddress);
-    int httpCode = http.GET();
+    InflateStream body;
+    int httpCode = ApiQuota::fetch(QUOTA_HOST_TWELVEDATA, 1, httpRequestAddress, http, body);
+    if (httpCode == QUOTA_NOT_SENT) {
+        // The probe of a half-open circuit failed with an earlier symbol
+        return false;
+    }
 
     if (httpCode > 0) { // Check for the returning code
-        String payload = http.getString();
         JsonDocument doc;
-        DeserializationError error = deserializeJson(doc, payload);
+        body.begin(http.getStream());
+        DeserializationError error = deserializeJson(doc, body);
 
-        if (!error) {
+        if (!error && doc["code"].as<int>() == 429) {
+            // twelvedata reports a used up quota in the body (with HTTP 200), the daily one resets at midnight UTC
+            time_t now = time(nullptr);
+            bool daily = doc["message"].as<String>().indexOf("for the day") >= 0 && now > 1700000000;
+            ApiQuota::getInstance()->blockFor(QUOTA_HOST_TWELVEDATA, daily ? (86400 - now % 86400) * 1000UL : QUOTA_BLOCK_DEFAULT);
+        } else if (!error) {
             float currentPrice = doc["close"].as<float>();
             if (currentPrice > 0.0) {
                 stock.setCurrentPrice(doc["close"].as<float>());
@@ -86,6 +174,7 @@ void StockWidget::getStockData(StockDataModel &stock) {
                 stock.setCompany(doc["name"].as<String>());
                 stock.setTicker(doc["symbol"].as<String>());
                 stock.setCurrencySymbol(doc["currency"].as<String>());
+                success = true;
             } else {
                 Serial.println("skipping invalid data for: " + stock.getSymbol());
             }
@@ -99,6 +188,49 @@ void StockWidget::getStockData(StockDataModel &stock) {
     }
 
     http.end();
+    return success;
+}
+
+// Show the last known prices until the first fetch is done
+void StockWidget::restoreSnapshot() {
+    SnapshotReader in;
+    if (!Snapshot::getInstance()->restore("stocks", STOCK_SNAPSHOT_VERSION, in)) {
+        return;
+    }
+    // Matched by symbol, the ticker list might have changed since
+    int count = in.readU8();
+    for (int i = 0; i < count && in.ok(); i++) {
+        String symbol = in.readString();
+        StockDataModel stock;
+        stock.setSymbol(symbol);
+        if (!stock.load(in)) {
+            break;
+        }
+        for (int8_t j = 0; j < m_stockCount; j++) {
+            if (m_stocks[j].getSymbol() == symbol) {
+                m_stocks[j] = stock;
+            }
+        }
+    }
+}
+
+// Stocks without a price yet (failed fetch) are left out
+void StockWidget::saveSnapshot() {
+    SnapshotWriter out;
+    uint8_t count = 0;
+    for (int8_t i = 0; i < m_stockCount; i++) {
+        if (m_stocks[i].getCurrentPrice() != 0.0) {
+            count++;
+        }
+    }
+    out.writeU8(count);
+    for (int8_t i = 0; i < m_stockCount; i++) {
+        if (m_stocks[i].getCurrentPrice() != 0.0) {
+            out.writeString(m_stocks[i].getSymbol());
+            m_stocks[i].save(out);
+        }
+    }
+    Snapshot::getInstance()->save("stocks", STOCK_SNAPSHOT_VERSION, out);
 }
 
 void StockWidget::displayStock(int8_t displayIndex, StockDataModel &stock, uint32_t backgroundColor, uint32_t textColor) {
@@ -5,6 +5,10 @@
 #include <HTTPClient.h>
 #include <TFT_eSPI.h>
 
+#include "ApiQuota.h"
+#include "EndpointHealth.h"
+#include "InflateStream.h"
+#include "RefreshPolicy.h"
 #include "StockDataModel.h"
 #include "Widget.h"
 
@@ -16,19 +20,29 @@ public:
     void setup() override;
     void update(bool force = false) override;
     void draw(bool force = false) override;
+    void prefetch() override;
+    long getMillisToNextUpdate() override;
     void buttonPressed(uint8_t buttonId, ButtonState state) override;
     String getName() override;
 
     void changeMode();
 
 private:
-    void getStockData(StockDataModel &stock);
+    bool isFetchDue(RefreshPolicy &policy, bool pairs, bool force);
+    uint8_t countStocks(bool pairs);
+    long getMillisToNextFetch(RefreshPolicy &policy, bool pairs);
+    void fetchStocks(RefreshPolicy &policy, bool pairs);
+    bool getStockData(StockDataModel &stock);
     void displayStock(int8_t displayIndex, StockDataModel &stock, uint32_t backgroundColor, uint32_t textColor);
+    void restoreSnapshot();
+    void saveSnapshot();
 
-    unsigned long m_stockDelay = 900000; // default to 15m between updates
-    unsigned long m_stockDelayPrev = 0;
+    // default to 15m between updates, shares only during trading hours
+    RefreshPolicy m_refresh{900000};
+    RefreshPolicy m_marketRefresh{900000, true};
 
     StockDataModel m_stocks[MAX_STOCKS];
+    bool m_stale[MAX_STOCKS] = {}; // Stale indicator is on screen
     int8_t m_stockCount;
 };
 #endif // STOCK_WIDGET_H
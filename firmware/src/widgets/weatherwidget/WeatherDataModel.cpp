@@ -189,3 +189,33 @@ WeatherDataModel &WeatherDataModel::setChangedStatus(bool changed) {
     m_changed = changed;
     return *this;
 }
+
+void WeatherDataModel::save(SnapshotWriter &out) {
+    out.writeString(m_cityName);
+    out.writeString(m_currentWeatherText);
+    out.writeString(m_currentWeatherIcon);
+    out.writeFloat(m_currentWeatherDeg);
+    out.writeFloat(m_todayHigh);
+    out.writeFloat(m_todayLow);
+    for (int i = 0; i < 3; i++) {
+        out.writeString(m_daysIcons[i]);
+        out.writeFloat(m_daysHigh[i]);
+        out.writeFloat(m_daysLow[i]);
+    }
+}
+
+bool WeatherDataModel::load(SnapshotReader &in) {
+    m_cityName = in.readString();
+    m_currentWeatherText = in.readString();
+    m_currentWeatherIcon = in.readString();
+    m_currentWeatherDeg = in.readFloat();
+    m_todayHigh = in.readFloat();
+    m_todayLow = in.readFloat();
+    for (int i = 0; i < 3; i++) {
+        m_daysIcons[i] = in.readString();
+        m_daysHigh[i] = in.readFloat();
+        m_daysLow[i] = in.readFloat();
+    }
+    m_changed = true;
+    return in.ok();
+}
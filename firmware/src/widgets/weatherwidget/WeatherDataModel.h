@@ -1,6 +1,7 @@
 #ifndef WEAHTERDATA_MODEL_H
 #define WEAHTERDATA_MODEL_H
 
+#include "Snapshot.h"
 #include <Arduino.h>
 #include <iomanip>
 
@@ -44,6 +45,9 @@ public:
     bool isChanged();
     WeatherDataModel &setChangedStatus(bool changed);
 
+    void save(SnapshotWriter &out);
+    bool load(SnapshotReader &in);
+
 private:
     String m_cityName;
     String m_currentWeatherText = ""; // Weather Description
@@ -15,8 +15,12 @@
 
 #include "config_helper.h"
 
+#define WEATHER_SNAPSHOT_VERSION 1
+#define WEATHER_QUOTA_COST 4 // Visual Crossing counts every day of the forecast (today and next3days)
+
 WeatherWidget::WeatherWidget(ScreenManager &manager) : Widget(manager) {
     m_mode = MODE_HIGHS;
+    restoreSnapshot();
 }
 
 WeatherWidget::~WeatherWidget() {
@@ -41,6 +45,26 @@ void WeatherWidget::setup() {
     m_screenMode = WEATHER_SCREEN_MODE;
 #endif
     configureColors();
+    registerGlyphs();
+}
+
+// Fixed texts, names and digits for the glyph cache prewarm
+void WeatherWidget::registerGlyphs() {
+    const char *temperature = "-0123456789.°";
+    String months = "0123456789 ";
+    for (auto &month : LOC_MONTH) {
+        months += month;
+    }
+    String weekdays = "HighLows";
+    for (auto &weekday : LOC_WEEKDAY) {
+        weekdays += weekday;
+    }
+    m_manager.registerGlyphs(DEFAULT_FONT, 18, months.c_str());
+    m_manager.registerGlyphs(DEFAULT_FONT, 18, temperature);
+    m_manager.registerGlyphs(DEFAULT_FONT, 22, weekdays.c_str());
+    m_manager.registerGlyphs(DEFAULT_FONT, 22, temperature);
+    m_manager.registerGlyphs(DEFAULT_FONT, 66, "0123456789:");
+    m_manager.registerGlyphs(DEFAULT_FONT, 88, temperature);
 }
 
 void WeatherWidget::draw(bool force) {
@@ -52,8 +76,13 @@ void WeatherWidget::draw(bool force) {
         m_clockStamp = clockStamp;
     }
 
-    if (force || model.isChanged()) {
+    bool stale = m_refresh.isStale();
+    if (force || model.isChanged() || stale != m_stale) {
         weatherText(1);
+        if (stale) {
+            drawStaleIndicator(1);
+        }
+        m_stale = stale;
         drawWeatherIcon(2, model.getCurrentIcon(), 0, 0, 1);
         singleWeatherDeg(3);
         threeDayWeather(4);
@@ -62,28 +91,43 @@ void WeatherWidget::draw(bool force) {
 }
 
 void WeatherWidget::update(bool force) {
-    if (force || m_weatherDelayPrev == 0 || (millis() - m_weatherDelayPrev) >= m_weatherDelay) {
+    // Also forced updates wait for the quota and the backoff, failures are retried by EndpointHealth
+    if ((force || m_refresh.isDue(isVisible())) && ApiQuota::getInstance()->getMillisToAvailable(QUOTA_HOST_VISUALCROSSING, WEATHER_QUOTA_COST) == 0 &&
+        EndpointHealth::getInstance()->getMillisToRetry(QUOTA_HOST_VISUALCROSSING) == 0) {
         setBusy(true);
-        if (force) {
-            int retry = 0;
-            while (!getWeatherData() && retry++ < MAX_RETRIES)
-                ;
-        } else {
-            getWeatherData();
+        int httpCode;
+        if (getWeatherData(httpCode)) {
+            m_refresh.fetched(saveSnapshot());
+        } else if (httpCode != QUOTA_NOT_SENT) {
+            // No connection or a server error means the endpoint is down. After e.g. an invalid key
+            // or location wait for the interval, asking again right away gives the same answer.
+            m_refresh.failed(httpCode < 0 || httpCode >= 500);
         }
         setBusy(false);
-        m_weatherDelayPrev = millis();
     }
 }
 
-bool WeatherWidget::getWeatherData() {
+void WeatherWidget::prefetch() {
+    update();
+}
+
+long WeatherWidget::getMillisToNextUpdate() {
+    long next = max(m_refresh.getMillisToNext(isVisible()), ApiQuota::getInstance()->getMillisToAvailable(QUOTA_HOST_VISUALCROSSING, WEATHER_QUOTA_COST));
+    return max(next, EndpointHealth::getInstance()->getMillisToRetry(QUOTA_HOST_VISUALCROSSING));
+}
+
+// The HTTP code of the answer goes to httpCode, returns false if there is no weather data in it
+bool WeatherWidget::getWeatherData(int &httpCode) {
     HTTPClient http;
-    http.begin(httpRequestAddress);
-    int httpCode = http.GET();
-    if (httpCode > 0) {
-        // Check for the return code   TODO: factor out
+    InflateStream body;
+    httpCode = ApiQuota::fetch(QUOTA_HOST_VISUALCROSSING, WEATHER_QUOTA_COST, httpRequestAddress, http, body);
+    if (httpCode == QUOTA_NOT_SENT) {
+        return false;
+    }
+    if (httpCode == HTTP_CODE_OK) {
         JsonDocument doc;
-        DeserializationError error = deserializeJson(doc, http.getString());
+        body.begin(http.getStream());
+        DeserializationError error = deserializeJson(doc, body);
         http.end();
 
         if (!error) {
@@ -120,13 +164,35 @@ bool WeatherWidget::getWeatherData() {
         }
     } else {
         // Handle HTTP request error
-        Serial.printf("HTTP request failed, error: %s\n", http.errorToString(httpCode).c_str());
+        Serial.printf("HTTP request failed, code: %d, error: %s\n", httpCode, http.errorToString(httpCode).c_str());
         http.end();
         return false;
     }
     return true;
 }
 
+// Show the last known weather until the first fetch is done
+void WeatherWidget::restoreSnapshot() {
+    SnapshotReader in;
+    if (!Snapshot::getInstance()->restore("weather", WEATHER_SNAPSHOT_VERSION, in)) {
+        return;
+    }
+    // Only if it's still the same location and units
+    if (in.readString() != weatherLocation || in.readString() != weatherUnits || !model.load(in)) {
+        model = WeatherDataModel();
+    }
+}
+
+// Returns the checksum of the data, to notice fetches without changes
+uint32_t WeatherWidget::saveSnapshot() {
+    SnapshotWriter out;
+    out.writeString(weatherLocation);
+    out.writeString(weatherUnits);
+    model.save(out);
+    Snapshot::getInstance()->save("weather", WEATHER_SNAPSHOT_VERSION, out);
+    return out.getChecksum();
+}
+
 void WeatherWidget::displayClock(int displayIndex) {
     const int clockY = 120;
     const int dayOfWeekY = 190;
@@ -137,8 +203,7 @@ void WeatherWidget::displayClock(int displayIndex) {
     m_manager.setFontColor(m_foregroundColor);
 
     m_manager.drawCentreString(m_time->getDayAndMonth(), centre, dateY, 18);
-    const String weekDay = m_time->getWeekday();
-    m_manager.drawCentreString(weekDay, centre, dayOfWeekY, 22);
+    m_manager.drawCentreString(m_time->getWeekday(), centre, dayOfWeekY, 22);
 
     m_manager.drawString(m_time->getHourPadded(), centre - 10, clockY, 66, Align::MiddleRight);
     m_manager.drawString(":", centre, clockY, 66, Align::MiddleCenter);
@@ -146,15 +211,11 @@ void WeatherWidget::displayClock(int displayIndex) {
 }
 
 // Write an image to the screen from a hex array.
-// scale of the image (1=full size, then multiples of 2 to scale down)
+// scale of the image (1=full size, then multiples of 2 to scale down), packed icons need the scale in custom_image_scales
 // getting the byte array size is very annoying as it's computed on compile, so you can't do it dynamically.
-void WeatherWidget::showJPG(int displayIndex, int x, int y, const byte jpgData[], int jpgDataSize, int scale) {
+void WeatherWidget::showImage(int displayIndex, int x, int y, const byte imageData[], int imageDataSize, int scale) {
     m_manager.selectScreen(displayIndex);
-
-    TJpgDec.setJpgScale(scale);
-    uint16_t w = 0, h = 0;
-    TJpgDec.getJpgSize(&w, &h, jpgData, jpgDataSize);
-    TJpgDec.drawJpg(x, y, jpgData, jpgDataSize);
+    m_manager.drawImage(x, y, imageData, imageDataSize, scale);
 }
 
 // Take the text output from the weather API and map it to a icon/byte array, then display it
@@ -163,33 +224,33 @@ void WeatherWidget::drawWeatherIcon(int displayIndex, const String &condition, i
     const byte *iconEnd = NULL;
 
     if (condition == "partly-cloudy-night") {
-        iconStart = m_screenMode == Light ? moonCloudW_start : moonCloudB_start;
-        iconEnd = m_screenMode == Light ? moonCloudW_end : moonCloudB_end;
+        iconStart = m_screenMode == Light ? moonCloudW_start() : moonCloudB_start();
+        iconEnd = m_screenMode == Light ? moonCloudW_end() : moonCloudB_end();
     } else if (condition == "partly-cloudy-day") {
-        iconStart = m_screenMode == Light ? sunCloudsW_start : sunCloudsB_start;
-        iconEnd = m_screenMode == Light ? sunCloudsW_end : sunCloudsB_end;
+        iconStart = m_screenMode == Light ? sunCloudsW_start() : sunCloudsB_start();
+        iconEnd = m_screenMode == Light ? sunCloudsW_end() : sunCloudsB_end();
     } else if (condition == "clear-day") {
-        iconStart = m_screenMode == Light ? sunW_start : sunB_start;
-        iconEnd = m_screenMode == Light ? sunW_end : sunB_end;
+        iconStart = m_screenMode == Light ? sunW_start() : sunB_start();
+        iconEnd = m_screenMode == Light ? sunW_end() : sunB_end();
     } else if (condition == "clear-night") {
-        iconStart = m_screenMode == Light ? moonW_start : moonB_start;
-        iconEnd = m_screenMode == Light ? moonW_end : moonB_end;
+        iconStart = m_screenMode == Light ? moonW_start() : moonB_start();
+        iconEnd = m_screenMode == Light ? moonW_end() : moonB_end();
     } else if (condition == "snow") {
-        iconStart = m_screenMode == Light ? snowW_start : snowB_start;
-        iconEnd = m_screenMode == Light ? snowW_end : snowB_end;
+        iconStart = m_screenMode == Light ? snowW_start() : snowB_start();
+        iconEnd = m_screenMode == Light ? snowW_end() : snowB_end();
     } else if (condition == "rain") {
-        iconStart = m_screenMode == Light ? rainW_start : rainB_start;
-        iconEnd = m_screenMode == Light ? rainW_end : rainB_end;
+        iconStart = m_screenMode == Light ? rainW_start() : rainB_start();
+        iconEnd = m_screenMode == Light ? rainW_end() : rainB_end();
     } else if (condition == "fog" || condition == "wind" || condition == "cloudy") {
-        iconStart = m_screenMode == Light ? cloudsW_start : cloudsB_start;
-        iconEnd = m_screenMode == Light ? cloudsW_end : cloudsB_end;
+        iconStart = m_screenMode == Light ? cloudsW_start() : cloudsB_start();
+        iconEnd = m_screenMode == Light ? cloudsW_end() : cloudsB_end();
     } else {
         Serial.println("unknown weather icon:" + condition);
     }
 
     const int size = iconEnd - iconStart;
     if (iconStart != NULL && size > 0) {
-        showJPG(displayIndex, x, y, iconStart, size, scale);
+        showImage(displayIndex, x, y, iconStart, size, scale);
     }
 }
 
@@ -221,25 +282,8 @@ void WeatherWidget::singleWeatherDeg(int displayIndex) {
 void WeatherWidget::weatherText(int displayIndex) {
     m_manager.selectScreen(displayIndex);
 
-    //=== TEXT OVERFLOW ============================
-    // This takes a given string a and breaks it down in max x character long strings ensuring not to break it only at a space.
-    // Given the small width of the screens this will porbablly be needed to this project again so making sure to outline it
-    // clearly as this should liekly eventually be turned into a fucntion. Before use the array size should be made to be dynamic.
-    // In this case its used for the weather text description
-
-    String message = model.getCurrentText() + " ";
-    String messageArr[4];
-    int variableRangeS = 0;
-    int variableRangeE = 18;
-    for (int i = 0; i < 4; i++) {
-        while (message.substring(variableRangeE - 1, variableRangeE) != " ") {
-            variableRangeE--;
-        }
-        messageArr[i] = message.substring(variableRangeS, variableRangeE);
-        variableRangeS = variableRangeE;
-        variableRangeE = variableRangeS + 18;
-    }
-    //=== OVERFLOW END ==============================
+    char message[128];
+    strlcpy(message, model.getCurrentText().c_str(), sizeof(message));
 
     m_manager.fillScreen(m_backgroundColor);
     String cityName = model.getCityName();
@@ -248,9 +292,12 @@ void WeatherWidget::weatherText(int displayIndex) {
     m_manager.setFontColor(m_foregroundColor);
     m_manager.drawFittedString(cityName, centre, 80, 210, 50, Align::MiddleCenter);
 
+    // Wrap by the real text width, the lowest line only has about 180 px on the round screen
+    const char *lines[MAX_WRAPPED_LINES];
+    int lineCount = m_manager.wrapText(message, 180, 15, lines, 4);
     auto y = 125;
-    for (auto i = 0; i < 4; i++) {
-        m_manager.drawCentreString(messageArr[i], centre, y, 15);
+    for (auto i = 0; i < lineCount; i++) {
+        m_manager.drawCentreString(lines[i], centre, y, 15);
         y += 25;
     }
 }
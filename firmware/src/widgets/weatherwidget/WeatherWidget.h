@@ -1,14 +1,17 @@
 #ifndef WEATHERWIDGET_H
 #define WEATHERWIDGET_H
 
+#include "ApiQuota.h"
+#include "EndpointHealth.h"
 #include "GlobalTime.h"
+#include "InflateStream.h"
+#include "RefreshPolicy.h"
 #include "Utils.h"
 #include "WeatherDataModel.h"
 #include "Widget.h"
 #include "config_helper.h"
 #include <ArduinoJson.h>
 #include <HTTPClient.h>
-#include <TJpg_Decoder.h>
 #include <math.h>
 
 class WeatherWidget : public Widget {
@@ -18,6 +21,8 @@ public:
     void setup() override;
     void update(bool force = false) override;
     void draw(bool force = false) override;
+    void prefetch() override;
+    long getMillisToNextUpdate() override;
     void buttonPressed(uint8_t buttonId, ButtonState state) override;
     String getName() override;
 
@@ -25,14 +30,17 @@ private:
     void displayClock(int displayIndex);
     void changeMode();
     void displayClock(int displayIndex, uint32_t background, uint32_t textColor);
-    void showJPG(int displayIndex, int x, int y, const byte jpgData[], int size, int scale);
+    void showImage(int displayIndex, int x, int y, const byte imageData[], int size, int scale);
     void drawWeatherIcon(int displayIndex, const String &condition, int x, int y, int scale);
     void singleWeatherDeg(int displayIndex);
     void weatherText(int displayIndex);
     void threeDayWeather(int displayIndex);
-    bool getWeatherData();
+    bool getWeatherData(int &httpCode);
+    void restoreSnapshot();
+    uint32_t saveSnapshot();
     int getClockStamp();
     void configureColors();
+    void registerGlyphs();
 
     GlobalTime *m_time;
     int8_t m_mode;
@@ -43,8 +51,8 @@ private:
     uint16_t m_invertedForegroundColor;
     uint16_t m_invertedBackgroundColor;
 
-    const long m_weatherDelay = 600000; // Weather refresh rate
-    unsigned long m_weatherDelayPrev = 0;
+    RefreshPolicy m_refresh{600000}; // Weather refresh rate
+    bool m_stale = false; // Stale indicator is on screen
 
     const int centre = 120; // Centre location of the screen(240x240)
 
@@ -16,6 +16,8 @@ public:
 
     void setImage(String image);
     String getImage();
+    int32_t getScale();
+    void setScale(int32_t scale);
 
     void parseData(const JsonObject &doc, int32_t defaultColor, int32_t defaultBackground) override;
     void draw(ScreenManager &manager) override;
@@ -23,6 +25,8 @@ public:
 private:
     int32_t m_x = 0;
     int32_t m_y = 0;
-    String m_image = "";
+    String m_image = ""; // URL of a (baseline) JPEG
+    int32_t m_scale = 1;
+    String m_file = ""; // Downloaded image in LittleFS
 };
 #endif
@@ -0,0 +1,282 @@
+#include "WebDataImageCache.h"
+
+#include "EndpointHealth.h"
+#include "Utils.h"
+#include <ArduinoJson.h>
+#include <HTTPClient.h>
+#include <LittleFS.h>
+
+#define WEB_DATA_IMAGE_CACHE_DIR "/webdata"
+#define WEB_DATA_IMAGE_CACHE_INDEX WEB_DATA_IMAGE_CACHE_DIR "/index.json"
+#define WEB_DATA_IMAGE_CACHE_TEMP WEB_DATA_IMAGE_CACHE_DIR "/download.tmp"
+
+WebDataImageCache *WebDataImageCache::m_instance = nullptr;
+
+// Writes the download into a file and hashes it on the way (FNV-1a).
+// Refuses everything past limit, so a huge chunked body can't fill the partition.
+class ChecksumFileStream : public Stream {
+public:
+    ChecksumFileStream(fs::File &file, size_t limit) : m_file(file), m_limit(limit) {}
+
+    size_t write(uint8_t c) override {
+        return write(&c, 1);
+    }
+    size_t write(const uint8_t *buffer, size_t size) override {
+        if (m_written + size > m_limit) {
+            // HTTPClient fails the download on a short write
+            return 0;
+        }
+        m_written += size;
+        m_checksum = Utils::fnv1a(buffer, size, m_checksum);
+        return m_file.write(buffer, size);
+    }
+    int available() override {
+        return 0;
+    }
+    int read() override {
+        return -1;
+    }
+    int peek() override {
+        return -1;
+    }
+    void flush() override {
+        m_file.flush();
+    }
+    uint32_t getChecksum() {
+        return m_checksum;
+    }
+
+private:
+    fs::File &m_file;
+    size_t m_limit;
+    size_t m_written = 0;
+    uint32_t m_checksum = FNV1A_INITIAL;
+};
+
+WebDataImageCache *WebDataImageCache::getInstance() {
+    if (m_instance == nullptr) {
+        m_instance = new WebDataImageCache();
+    }
+    return m_instance;
+}
+
+bool WebDataImageCache::begin() {
+    if (!m_begun) {
+        m_begun = true;
+        m_available = Utils::beginLittleFS();
+        if (m_available) {
+            if (!LittleFS.exists(WEB_DATA_IMAGE_CACHE_DIR)) {
+                LittleFS.mkdir(WEB_DATA_IMAGE_CACHE_DIR);
+            }
+            loadIndex();
+        } else {
+            Serial.println("WebDataImageCache: LittleFS not available");
+        }
+    }
+    return m_available;
+}
+
+void WebDataImageCache::loadIndex() {
+    m_entries.clear();
+    fs::File f = LittleFS.open(WEB_DATA_IMAGE_CACHE_INDEX, "r");
+    if (!f) {
+        return;
+    }
+    JsonDocument doc;
+    DeserializationError error = deserializeJson(doc, f);
+    f.close();
+    if (error) {
+        Serial.println("WebDataImageCache: index broken, starting empty");
+        return;
+    }
+    m_clock = doc["clock"] | 0;
+    for (JsonObject entry : doc["entries"].as<JsonArray>()) {
+        String url = entry["url"] | "";
+        // Drop entries whose file got lost
+        if (url.length() > 0 && LittleFS.exists(filePath(url))) {
+            m_entries.push_back({url, entry["etag"] | "", entry["size"] | 0u, entry["sum"] | 0u, entry["used"] | 0u});
+        }
+    }
+    Serial.printf("WebDataImageCache: %d images, %d bytes\n", (int) m_entries.size(), (int) usedBytes());
+}
+
+// Only written when images are added, removed or changed, the LRU order of plain cache hits is kept in RAM (flash wear)
+void WebDataImageCache::saveIndex() {
+    JsonDocument doc;
+    doc["clock"] = m_clock;
+    JsonArray entries = doc["entries"].to<JsonArray>();
+    for (const Entry &entry : m_entries) {
+        JsonObject obj = entries.add<JsonObject>();
+        obj["url"] = entry.url;
+        obj["etag"] = entry.etag;
+        obj["size"] = entry.size;
+        obj["sum"] = entry.checksum;
+        obj["used"] = entry.lastUsed;
+    }
+    fs::File f = LittleFS.open(WEB_DATA_IMAGE_CACHE_INDEX, "w");
+    if (f) {
+        serializeJson(doc, f);
+        f.close();
+    }
+}
+
+int WebDataImageCache::findEntry(const String &url) {
+    for (int i = 0; i < m_entries.size(); i++) {
+        if (m_entries[i].url == url) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// File name from the FNV-1a hash of the URL
+String WebDataImageCache::filePath(const String &url) {
+    char path[32];
+    snprintf(path, sizeof(path), WEB_DATA_IMAGE_CACHE_DIR "/%08x.jpg", Utils::fnv1a(url));
+    return path;
+}
+
+void WebDataImageCache::removeEntry(int index) {
+    LittleFS.remove(filePath(m_entries[index].url));
+    m_entries.erase(m_entries.begin() + index);
+}
+
+uint32_t WebDataImageCache::usedBytes() {
+    uint32_t used = 0;
+    for (const Entry &entry : m_entries) {
+        used += entry.size;
+    }
+    return used;
+}
+
+// Remove the least recently used images (except keepUrl) until size more bytes and one more image fit
+void WebDataImageCache::makeRoom(uint32_t size, const String &keepUrl) {
+    while (true) {
+        uint32_t used = size;
+        int count = 1;
+        int oldest = -1;
+        for (int i = 0; i < m_entries.size(); i++) {
+            if (m_entries[i].url == keepUrl) {
+                continue;
+            }
+            used += m_entries[i].size;
+            count++;
+            if (oldest < 0 || m_entries[i].lastUsed < m_entries[oldest].lastUsed) {
+                oldest = i;
+            }
+        }
+        if (oldest < 0 || (used <= WEB_DATA_IMAGE_CACHE_BYTES && count <= WEB_DATA_IMAGE_CACHE_ENTRIES)) {
+            return;
+        }
+        Serial.printf("WebDataImageCache: removing %s\n", m_entries[oldest].url.c_str());
+        removeEntry(oldest);
+    }
+}
+
+bool WebDataImageCache::fetch(const String &url, String &path) {
+    if (!begin()) {
+        return false;
+    }
+    int index = findEntry(url);
+    String host = EndpointHealth::hostOf(url);
+    if (!EndpointHealth::getInstance()->allow(host)) {
+        // Restoring a snapshot at boot or the server is down, use what we have without waiting for a timeout
+        if (index >= 0) {
+            path = filePath(url);
+            return true;
+        }
+        return false;
+    }
+
+    HTTPClient http;
+    http.begin(url);
+    const char *headerKeys[] = {"ETag"};
+    http.collectHeaders(headerKeys, 1);
+    if (index >= 0 && m_entries[index].etag.length() > 0) {
+        http.addHeader("If-None-Match", m_entries[index].etag);
+    }
+    int httpCode = http.GET();
+    if (httpCode > 0 && httpCode < 500) {
+        EndpointHealth::getInstance()->success(host);
+    } else {
+        EndpointHealth::getInstance()->failure(host);
+    }
+
+    if (httpCode == HTTP_CODE_NOT_MODIFIED && index >= 0) {
+        http.end();
+        m_entries[index].lastUsed = ++m_clock;
+        path = filePath(url);
+        return true;
+    }
+    if (httpCode != HTTP_CODE_OK) {
+        Serial.printf("WebDataImageCache: %s failed, error: %s\n", url.c_str(), http.errorToString(httpCode).c_str());
+        http.end();
+        if (index >= 0) {
+            // Show the last image we have
+            path = filePath(url);
+            return true;
+        }
+        return false;
+    }
+
+    int size = http.getSize(); // -1 without Content-Length (chunked)
+    if (size > WEB_DATA_IMAGE_CACHE_BYTES) {
+        Serial.printf("WebDataImageCache: %s is too big (%d bytes)\n", url.c_str(), size);
+        http.end();
+        return false;
+    }
+    makeRoom(size > 0 ? size : 0, url);
+
+    // Stream the body into a temporary file, so a failed download keeps the cached image
+    fs::File f = LittleFS.open(WEB_DATA_IMAGE_CACHE_TEMP, "w");
+    ChecksumFileStream download(f, WEB_DATA_IMAGE_CACHE_BYTES);
+    int written = f ? http.writeToStream(&download) : -1;
+    if (f) {
+        f.close();
+    }
+    String etag = http.header("ETag");
+    http.end();
+    if (written <= 0 || (size > 0 && written != size)) {
+        Serial.printf("WebDataImageCache: download of %s failed (%d bytes)\n", url.c_str(), written);
+        LittleFS.remove(WEB_DATA_IMAGE_CACHE_TEMP);
+        index = findEntry(url);
+        if (index >= 0) {
+            path = filePath(url);
+            return true;
+        }
+        return false;
+    }
+
+    path = filePath(url);
+    uint32_t checksum = download.getChecksum();
+    index = findEntry(url);
+    if (index >= 0 && m_entries[index].size == (uint32_t) written && m_entries[index].checksum == checksum) {
+        // Same image again (no ETag support, or only the ETag changed), keep the cached file
+        LittleFS.remove(WEB_DATA_IMAGE_CACHE_TEMP);
+        m_entries[index].lastUsed = ++m_clock;
+        if (m_entries[index].etag != etag) {
+            m_entries[index].etag = etag;
+            saveIndex();
+        }
+        return true;
+    }
+    // Replaces the cached file atomically
+    if (!LittleFS.rename(WEB_DATA_IMAGE_CACHE_TEMP, path)) {
+        Serial.printf("WebDataImageCache: cannot replace %s\n", path.c_str());
+        LittleFS.remove(WEB_DATA_IMAGE_CACHE_TEMP);
+        return index >= 0;
+    }
+    if (index < 0) {
+        m_entries.push_back({url, etag, (uint32_t) written, checksum, ++m_clock});
+    } else {
+        m_entries[index].etag = etag;
+        m_entries[index].size = written;
+        m_entries[index].checksum = checksum;
+        m_entries[index].lastUsed = ++m_clock;
+    }
+    // The size wasn't known before a chunked download
+    makeRoom(written, url);
+    saveIndex();
+    Serial.printf("WebDataImageCache: cached %s (%d bytes)\n", url.c_str(), written);
+    return true;
+}
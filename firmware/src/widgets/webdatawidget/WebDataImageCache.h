@@ -0,0 +1,55 @@
+#ifndef WEB_DATA_IMAGE_CACHE_H
+#define WEB_DATA_IMAGE_CACHE_H
+
+#include <Arduino.h>
+#include <vector>
+
+// Flash space for downloaded images (the LittleFS partition is 640 KB)
+#ifndef WEB_DATA_IMAGE_CACHE_BYTES
+    #define WEB_DATA_IMAGE_CACHE_BYTES 262144
+#endif
+
+#ifndef WEB_DATA_IMAGE_CACHE_ENTRIES
+    #define WEB_DATA_IMAGE_CACHE_ENTRIES 16
+#endif
+
+// Images of WebData elements, downloaded into LittleFS and kept by URL.
+// Later polls only ask the server whether the image changed (If-None-Match with the ETag),
+// the least recently used images are removed when the cache is full.
+class WebDataImageCache {
+public:
+    static WebDataImageCache *getInstance();
+
+    // Download the image (or revalidate the cached one) and return the LittleFS path of the file in path.
+    // Returns false if there is neither a new nor a cached image.
+    bool fetch(const String &url, String &path);
+
+private:
+    struct Entry {
+        String url;
+        String etag;
+        uint32_t size;
+        uint32_t checksum; // FNV-1a of the file, servers without ETags send the same image again
+        uint32_t lastUsed;
+    };
+
+    WebDataImageCache() = default;
+
+    bool begin();
+    void loadIndex();
+    void saveIndex();
+    int findEntry(const String &url);
+    String filePath(const String &url);
+    void removeEntry(int index);
+    void makeRoom(uint32_t size, const String &keepUrl);
+    uint32_t usedBytes();
+
+    static WebDataImageCache *m_instance;
+
+    std::vector<Entry> m_entries;
+    uint32_t m_clock = 0; // Increased for every use, orders the entries for LRU
+    bool m_begun = false;
+    bool m_available = false;
+};
+
+#endif
@@ -172,15 +172,16 @@ void WebDataModel::draw(ScreenManager &manager) {
             element.draw(manager);
         }
     } else {
-        manager.setLegacyTextColor(getDataColor(), getBackgroundColor());
-
-        String wrappedLines[MAX_WRAPPED_LINES];
-        String dataValues = getData();
+        const char *wrappedLines[MAX_WRAPPED_LINES];
+        char data[256];
+        strlcpy(data, getData().c_str(), sizeof(data));
         int yOffset = 110;
-        int lineCount = Utils::getWrappedLines(wrappedLines, dataValues, 10);
-        int height = manager.getLegacyFontHeight() + 10;
+        // Roughly the size of the legacy font 2 at text size 2 that was used before
+        manager.setFont(DEFAULT_FONT);
+        int lineCount = manager.wrapText(data, 200, 22, wrappedLines);
+        int height = 40;
         for (int i = 0; i < lineCount; i++) {
-            manager.drawLegacyString(wrappedLines[i], 120, yOffset + (height * i), 2);
+            manager.drawString(wrappedLines[i], 120, yOffset + (height * i), 22, Align::MiddleCenter, getDataColor(), getBackgroundColor());
         }
     }
 }
@@ -1,13 +1,16 @@
 
 #include "WebDataWidget.h"
 
+#define WEB_DATA_SNAPSHOT_VERSION 1
+
 WebDataWidget::WebDataWidget(ScreenManager &manager, String url) : Widget(manager) {
     httpRequestAddress = url;
+    m_host = EndpointHealth::hostOf(url);
 
-    m_lastUpdate = 0;
     for (int i = 0; i < 5; i++) {
         m_obj[i] = WebDataModel();
     }
+    restoreSnapshot();
 }
 
 WebDataWidget::~WebDataWidget() {
@@ -20,6 +23,13 @@ void WebDataWidget::buttonPressed(uint8_t buttonId, ButtonState state) {
 }
 
 void WebDataWidget::draw(bool force) {
+    bool stale = m_refresh.isStale();
+    if (stale != m_stale) {
+        // Redraw the first screen from scratch to show or remove the indicator
+        m_obj[0].setInitializedStatus(false);
+        m_obj[0].setChangedStatus(true);
+    }
+    m_stale = stale;
     for (int i = 0; i < 5; i++) {
         WebDataModel *data = &m_obj[i];
         if (force) {
@@ -28,6 +38,9 @@ void WebDataWidget::draw(bool force) {
         if (data->isChanged() || force) {
             m_manager.selectScreen(i);
             data->draw(m_manager);
+            if (i == 0 && stale) {
+                drawStaleIndicator(0);
+            }
 
             data->setChangedStatus(false);
         }
@@ -35,17 +48,23 @@ void WebDataWidget::draw(bool force) {
 }
 
 void WebDataWidget::update(bool force) {
-    if (force || m_lastUpdate == 0 || (millis() - m_lastUpdate) >= m_updateDelay) {
+    // Also forced updates wait for the backoff after failures and a 429
+    if (force || m_refresh.isDue(isVisible())) {
+        bool success = false;
         HTTPClient http;
-        http.begin(httpRequestAddress);
-        int httpCode = http.GET();
+        InflateStream body;
+        int httpCode = ApiQuota::fetch(m_host, 1, httpRequestAddress, http, body);
+        if (httpCode == QUOTA_NOT_SENT) {
+            return;
+        }
 
         if (httpCode > 0) { // Check for the returning code
             JsonDocument doc;
-            DeserializationError error = deserializeJson(doc, http.getString());
+            body.begin(http.getStream());
+            DeserializationError error = deserializeJson(doc, body);
             if (!error) {
                 if (doc["interval"].is<int>()) {
-                    m_updateDelay = doc["interval"];
+                    m_refresh.setInterval(doc["interval"]);
                 }
                 JsonVariant array;
                 if (doc["displays"].is<JsonArray>()) {
@@ -54,10 +73,9 @@ void WebDataWidget::update(bool force) {
                     // Handle legacy response that doesn't have response level data
                     array = doc.as<JsonArray>();
                 }
-                for (int i = 0; i < array.size(); i++) {
-                    m_obj[i].parseData(array[i].as<JsonObject>(), m_defaultColor, m_defaultBackground);
-                }
-                m_lastUpdate = millis();
+                parseDisplays(array.as<JsonArray>());
+                m_refresh.fetched(saveSnapshot(array.as<JsonArray>()));
+                success = true;
             } else {
                 // Handle JSON deserialization error
                 Serial.println("deserializeJson() failed");
@@ -67,7 +85,62 @@ void WebDataWidget::update(bool force) {
             Serial.printf("HTTP request failed, error: %s\n", http.errorToString(httpCode).c_str());
         }
         http.end();
+        if (!success) {
+            // An error page or broken JSON waits for the next interval, a server that is down for the backoff
+            m_refresh.failed(EndpointHealth::getInstance()->getMillisToRetry(m_host) > 0);
+        }
+    }
+}
+
+void WebDataWidget::parseDisplays(JsonArray array) {
+    for (int i = 0; i < array.size() && i < 5; i++) {
+        m_obj[i].parseData(array[i].as<JsonObject>(), m_defaultColor, m_defaultBackground);
+    }
+}
+
+// One snapshot per URL, there can be more than one WebData widget
+String WebDataWidget::snapshotName() {
+    char name[20];
+    snprintf(name, sizeof(name), "webdata-%08x", Utils::fnv1a(httpRequestAddress));
+    return name;
+}
+
+// Show the last known displays until the first fetch is done
+void WebDataWidget::restoreSnapshot() {
+    SnapshotReader in;
+    if (!Snapshot::getInstance()->restore(snapshotName(), WEB_DATA_SNAPSHOT_VERSION, in) || in.readString() != httpRequestAddress) {
+        return;
     }
+    std::vector<uint8_t> packed(in.readU32());
+    if (!in.readBytes(packed.data(), packed.size())) {
+        return;
+    }
+    JsonDocument doc;
+    if (deserializeMsgPack(doc, packed.data(), packed.size()) == DeserializationError::Ok) {
+        parseDisplays(doc.as<JsonArray>());
+    }
+}
+
+// The displays are kept as MessagePack, the elements are parsed the same way as a response.
+// Returns the checksum of the data, to notice fetches without changes
+uint32_t WebDataWidget::saveSnapshot(JsonArray array) {
+    std::vector<uint8_t> packed(measureMsgPack(array));
+    serializeMsgPack(array, packed.data(), packed.size());
+    SnapshotWriter out;
+    out.writeString(httpRequestAddress);
+    out.writeU32(packed.size());
+    out.writeBytes(packed.data(), packed.size());
+    Snapshot::getInstance()->save(snapshotName(), WEB_DATA_SNAPSHOT_VERSION, out);
+    return out.getChecksum();
+}
+
+void WebDataWidget::prefetch() {
+    update();
+}
+
+long WebDataWidget::getMillisToNextUpdate() {
+    long next = max(m_refresh.getMillisToNext(isVisible()), ApiQuota::getInstance()->getMillisToAvailable(m_host));
+    return max(next, EndpointHealth::getInstance()->getMillisToRetry(m_host));
 }
 
 String WebDataWidget::getName() {
@@ -5,6 +5,11 @@
 #include <ArduinoJson.h>
 #include <HTTPClient.h>
 
+#include "ApiQuota.h"
+#include "EndpointHealth.h"
+#include "InflateStream.h"
+#include "RefreshPolicy.h"
+#include "Snapshot.h"
 #include "Utils.h"
 #include "WebDataModel.h"
 
@@ -15,13 +20,21 @@ public:
     void setup() override;
     void update(bool force = false) override;
     void draw(bool force = false) override;
+    void prefetch() override;
+    long getMillisToNextUpdate() override;
     void buttonPressed(uint8_t buttonId, ButtonState state) override;
     String getName() override;
 
 private:
-    unsigned long m_lastUpdate = 0;
-    unsigned long m_updateDelay = 1000;
+    void parseDisplays(JsonArray array);
+    void restoreSnapshot();
+    uint32_t saveSnapshot(JsonArray array);
+    String snapshotName();
+
+    RefreshPolicy m_refresh{1000}; // The response can set another interval
     String httpRequestAddress;
+    String m_host;
+    bool m_stale = false; // Stale indicator is on the first screen
     WebDataModel m_obj[5];
     int32_t m_defaultColor = TFT_WHITE;
     int32_t m_defaultBackground = TFT_BLACK;
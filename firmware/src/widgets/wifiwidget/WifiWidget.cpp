@@ -1,5 +1,6 @@
 #include "WifiWidget.h"
 #include "Utils.h"
+#include <Preferences.h>
 #include <WiFi.h>
 #include <WiFiManager.h> // https://github.com/tzapu/WiFiManager
 
@@ -21,11 +22,21 @@ void WifiWidget::setup() {
     m_manager.setFontColor(TFT_WHITE);
     m_manager.drawCentreString("Connecting", ScreenCenterX, ScreenCenterY - lineHeight, fontSize);
 
+    m_connectStart = millis();
     WiFi.mode(WIFI_STA); // For WiFiManager explicitly set mode to station, ESP defaults to STA+AP
 
-#if (defined WIFI_SSID && defined WIFI_PASS)
-    m_hardCodedWiFi = true;
-    WiFi.begin(WIFI_SSID, WIFI_PASS);
+#if (defined WIFI_STATIC_IP && defined WIFI_STATIC_GATEWAY && defined WIFI_STATIC_SUBNET)
+    IPAddress ip, gateway, subnet, dns;
+    ip.fromString(WIFI_STATIC_IP);
+    gateway.fromString(WIFI_STATIC_GATEWAY);
+    subnet.fromString(WIFI_STATIC_SUBNET);
+    #ifdef WIFI_STATIC_DNS
+    dns.fromString(WIFI_STATIC_DNS);
+    #else
+    dns = gateway;
+    #endif
+    // Skips DHCP, WiFiManager keeps it as well
+    WiFi.config(ip, gateway, subnet, dns);
 #endif
 
     // Remove unwanted buttons from the config portal
@@ -39,6 +50,7 @@ void WifiWidget::setup() {
     // these are stored by the ESP WiFi library
     if (digitalRead(BUTTON_RIGHT) == Button::PRESSED_LEVEL) {
         wifimgr.resetSettings();
+        clearConnection();
         m_manager.drawCentreString("Wifi Settings reset", ScreenCenterX, ScreenCenterY + lineHeight, fontSize);
         delay(messageDelay);
     }
@@ -56,6 +68,22 @@ void WifiWidget::setup() {
     wifimgr.setCleanConnect(true);
     wifimgr.setConnectRetries(5);
 
+#if (defined WIFI_SSID && defined WIFI_PASS)
+    m_hardCodedWiFi = true;
+    String ssid = WIFI_SSID;
+    String pass = WIFI_PASS;
+#else
+    String ssid = wifimgr.getWiFiSSID(true);
+    String pass = wifimgr.getWiFiPass(true);
+#endif
+    if (fastConnect(ssid, pass)) {
+        m_fastConnected = true;
+        return;
+    }
+#if (defined WIFI_SSID && defined WIFI_PASS)
+    WiFi.begin(WIFI_SSID, WIFI_PASS);
+#endif
+
     // WiFiManager automatically connects using saved credentials...
     if (wifimgr.autoConnect(m_apssid.c_str())) {
         Serial.print("WifiManager connected.");
@@ -83,6 +111,10 @@ void WifiWidget::update(bool force) {
     wifimgr.process();
 
     if (WiFi.status() == WL_CONNECTED) {
+        if (!m_isConnected) {
+            Serial.printf("WiFi connected in %lu ms (%s)\n", millis() - m_connectStart, m_fastConnected ? "cached access point" : "WiFiManager");
+            saveConnection();
+        }
         m_isConnected = true;
         m_connectionString = "Connected";
         m_ipaddress = WiFi.localIP().toString();
@@ -121,7 +153,10 @@ void WifiWidget::draw(bool force) {
         Serial.println();
         Serial.println("Connected to WiFi");
         m_isConnected = true;
-        delay(messageDelay);
+        if (!m_fastConnected) {
+            // Only worth waiting for after a new setup, the IP is also logged
+            delay(messageDelay);
+        }
     } else if (m_connectionFailed && !m_hasDisplayedError) {
         m_hasDisplayedError = true;
         m_manager.fillRect(0, blankRectTop, ScreenWidth, ScreenHeight - blankRectTop, TFT_BLACK);
@@ -156,6 +191,52 @@ void WifiWidget::connectionTimedOut() {
     }
 }
 
+// Connect straight to the access point and channel of the last connection, without the scan WiFiManager does
+bool WifiWidget::fastConnect(const String &ssid, const String &pass) {
+    Preferences prefs;
+    prefs.begin("wifi", true);
+    uint8_t bssid[6];
+    bool cached = prefs.getBytes("bssid", bssid, sizeof(bssid)) == sizeof(bssid) && prefs.getString("ssid") == ssid;
+    int32_t channel = prefs.getUChar("channel", 0);
+    prefs.end();
+    if (ssid.length() == 0 || !cached || channel == 0) {
+        return false;
+    }
+    unsigned long start = millis();
+    WiFi.begin(ssid.c_str(), pass.c_str(), channel, bssid);
+    while (WiFi.status() != WL_CONNECTED && millis() - start < WIFI_FAST_CONNECT_TIMEOUT) {
+        delay(10);
+    }
+    if (WiFi.status() == WL_CONNECTED) {
+        return true;
+    }
+    Serial.printf("WiFi: %s not reachable on channel %d, scanning\n", ssid.c_str(), channel);
+    WiFi.disconnect();
+    return false;
+}
+
+// Remember access point and channel for fastConnect(), only written when they changed
+void WifiWidget::saveConnection() {
+    Preferences prefs;
+    prefs.begin("wifi", false);
+    uint8_t cached[6];
+    uint8_t *bssid = WiFi.BSSID();
+    if (bssid != nullptr && (prefs.getBytes("bssid", cached, sizeof(cached)) != sizeof(cached) || memcmp(cached, bssid, sizeof(cached)) != 0 ||
+                             prefs.getUChar("channel", 0) != WiFi.channel() || prefs.getString("ssid") != WiFi.SSID())) {
+        prefs.putBytes("bssid", bssid, 6);
+        prefs.putUChar("channel", WiFi.channel());
+        prefs.putString("ssid", WiFi.SSID());
+    }
+    prefs.end();
+}
+
+void WifiWidget::clearConnection() {
+    Preferences prefs;
+    prefs.begin("wifi", false);
+    prefs.clear();
+    prefs.end();
+}
+
 String WifiWidget::getName() {
     return "WiFi";
 }
\ No newline at end of file
@@ -4,6 +4,11 @@
 
     #include "Widget.h"
 
+    // Wait this many ms for the direct connect to the last access point before falling back to WiFiManager
+    #ifndef WIFI_FAST_CONNECT_TIMEOUT
+        #define WIFI_FAST_CONNECT_TIMEOUT 3000
+    #endif
+
 class WifiWidget : public Widget {
 public:
     WifiWidget(ScreenManager &manager);
@@ -18,6 +23,9 @@ public:
 
 private:
     void connectionTimedOut();
+    bool fastConnect(const String &ssid, const String &pass);
+    void saveConnection();
+    void clearConnection();
 
     bool m_isConnected{false};
     bool m_connectionFailed{false};
@@ -25,12 +33,14 @@ private:
     bool m_hasDisplayedError{false};
     bool m_hasDisplayedSuccess{false};
     bool m_configPortalRunning{false};
+    bool m_fastConnected{false};
 
     String m_connectionString{""};
     String m_dotsString{""};
     String m_ipaddress{""};
     String m_apssid{""};
     int m_connectionTimer{0};
+    unsigned long m_connectStart{0};
     const int m_connectionTimeout{10000};
 };
 
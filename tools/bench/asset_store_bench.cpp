@@ -0,0 +1,89 @@
+// Host benchmark for the asset store, with the store file mapped instead of the assets partition.
+// Checks every asset against its source file, draws the packed images straight from the mapping and
+// measures lookups through the same ASSET_STORE declarations the firmware uses.
+// Build and run with tools/bench/run_asset_bench.sh
+
+#include "AssetStore.h"
+#include "PackedImage.h"
+#include "icons.h"
+#include "ttf-fonts.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+static std::vector<unsigned char> readFile(const std::string &path) {
+    std::vector<unsigned char> data;
+    FILE *f = fopen(path.c_str(), "rb");
+    if (!f) {
+        return data;
+    }
+    int c;
+    while ((c = fgetc(f)) != EOF) {
+        data.push_back(c);
+    }
+    fclose(f);
+    return data;
+}
+
+// Same naming as tools/pack_assets.py
+static std::string assetName(const std::string &path) {
+    std::string name = path;
+    for (char &c : name) {
+        if (!isalnum((unsigned char) c)) {
+            c = '_';
+        }
+    }
+    return name;
+}
+
+// Arguments: iterations, then the asset paths (relative to the repository root)
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: ASSET_STORE_FILE=assets.bin %s iterations asset...\n", argv[0]);
+        return 1;
+    }
+    const int iterations = atoi(argv[1]);
+    if (!AssetStore::begin()) {
+        return 1;
+    }
+
+    int errors = 0;
+    for (int arg = 2; arg < argc; arg++) {
+        size_t size;
+        const byte *data = AssetStore::find(assetName(argv[arg]).c_str(), &size);
+        std::vector<unsigned char> file = readFile(argv[arg]);
+        if (data == nullptr || size != file.size() || memcmp(data, file.data(), size) != 0) {
+            fprintf(stderr, "%s: differs from the source file\n", argv[arg]);
+            errors++;
+        }
+    }
+    if (AssetStore::start("no_such_asset") != nullptr) {
+        fprintf(stderr, "Found a missing asset\n");
+        errors++;
+    }
+
+    // The declarations from the firmware headers resolve to the mapping
+    printf("RobotoRegular.ttf: %d bytes, logo.pimg: %d bytes\n", (int) (robotoRegular_end() - robotoRegular_start()), (int) (logo_end() - logo_start()));
+    static uint16_t framebuffer[240 * 240];
+    bool drawn = PackedImage::draw(0, 0, logo_start(), logo_end() - logo_start(), 1, [](int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t *pixels) {
+        memcpy(&framebuffer[y * 240], pixels, w * h * sizeof(uint16_t));
+        return true;
+    });
+    if (!drawn) {
+        fprintf(stderr, "Cannot draw the logo from the store\n");
+        errors++;
+    }
+
+    // Lookups, as done for every asset declaration
+    const char *names[] = {"fonts_subset_RobotoRegular_ttf", "images_packed_WeatherWidget_light_sunW_pimg", "images_packed_logo_pimg"};
+    auto start = std::chrono::steady_clock::now();
+    size_t total = 0;
+    for (int i = 0; i < iterations; i++) {
+        size_t size;
+        AssetStore::find(names[i % 3], &size);
+        total += size;
+    }
+    auto end = std::chrono::steady_clock::now();
+    printf("Lookup: %.3f us (%zu)\n", std::chrono::duration<double, std::micro>(end - start).count() / iterations, total);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,74 @@
+// Just enough of Arduino.h to build firmware modules (PackedImage, AssetStore, InflateStream) for the host benchmarks
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+typedef uint8_t byte;
+using std::max;
+using std::min;
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+inline unsigned long millis() {
+    static auto start = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct HostSerial {
+    template <typename... Args>
+    int printf(const char *format, Args... args) {
+        return ::printf(format, args...);
+    }
+    void println(const char *text) {
+        ::printf("%s\n", text);
+    }
+};
+static HostSerial Serial;
+
+struct HostESP {
+    uint32_t getMaxAllocHeap() {
+        return 100000;
+    }
+};
+static HostESP ESP;
+
+class Print {
+public:
+    virtual ~Print() = default;
+    virtual size_t write(uint8_t) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size) {
+        size_t n = 0;
+        while (size-- && write(*buffer++)) {
+            n++;
+        }
+        return n;
+    }
+    virtual void flush() {}
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    // Like the Arduino one, without the timeout: stops at the first missing byte
+    virtual size_t readBytes(char *buffer, size_t length) {
+        size_t count = 0;
+        int c;
+        while (count < length && (c = read()) >= 0) {
+            buffer[count++] = c;
+        }
+        return count;
+    }
+    size_t readBytes(uint8_t *buffer, size_t length) {
+        return readBytes((char *) buffer, length);
+    }
+};
+
+#endif
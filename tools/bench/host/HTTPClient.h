@@ -0,0 +1,20 @@
+// The parts of HTTPClient that InflateStream::prepare() uses, for the host benchmarks
+#ifndef HTTP_CLIENT_H
+#define HTTP_CLIENT_H
+
+#include <string>
+
+class HTTPClient {
+public:
+    void useHTTP10(bool http10) {
+        m_http10 = http10;
+    }
+    void addHeader(const char *name, const char *value) {
+        m_headers += std::string(name) + ": " + value + "\r\n";
+    }
+
+    bool m_http10 = false;
+    std::string m_headers;
+};
+
+#endif
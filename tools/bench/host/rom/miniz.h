@@ -0,0 +1,89 @@
+// tinfl from the ESP32 ROM, implemented with zlib for the host benchmarks.
+// Checks the calls against the contract of tinfl_decompress() with a wrapping output buffer: the
+// output buffer is always the same TINFL_LZ_DICT_SIZE window and every call continues where the
+// previous one stopped, wrapping to the start only at the end of the window. tinfl resolves back
+// references from that window, so any other use would corrupt the output on the ESP32.
+#ifndef ROM_MINIZ_H
+#define ROM_MINIZ_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <zlib.h>
+
+#define TINFL_LZ_DICT_SIZE 32768
+
+enum {
+    TINFL_FLAG_PARSE_ZLIB_HEADER = 1,
+    TINFL_FLAG_HAS_MORE_INPUT = 2,
+    TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF = 4,
+};
+
+typedef enum {
+    TINFL_STATUS_FAILED_CANNOT_MAKE_PROGRESS = -4,
+    TINFL_STATUS_BAD_PARAM = -3,
+    TINFL_STATUS_ADLER32_MISMATCH = -2,
+    TINFL_STATUS_FAILED = -1,
+    TINFL_STATUS_DONE = 0,
+    TINFL_STATUS_NEEDS_MORE_INPUT = 1,
+    TINFL_STATUS_HAS_MORE_OUTPUT = 2
+} tinfl_status;
+
+struct tinfl_decompressor {
+    z_stream z;
+    int state; // 0 = initialized, 1 = inflating, 2 = finished
+    const uint8_t *window;
+    size_t windowPos; // Where the next call has to continue
+};
+
+inline void tinfl_init(tinfl_decompressor *r) {
+    memset(r, 0, sizeof(tinfl_decompressor));
+}
+
+inline tinfl_status tinfl_finish(tinfl_decompressor *r, tinfl_status status) {
+    inflateEnd(&r->z);
+    r->state = 2;
+    return status;
+}
+
+inline tinfl_status tinfl_decompress(tinfl_decompressor *r, const uint8_t *pIn_buf_next, size_t *pIn_buf_size, uint8_t *pOut_buf_start, uint8_t *pOut_buf_next, size_t *pOut_buf_size, int decomp_flags) {
+    size_t outOffset = pOut_buf_next - pOut_buf_start;
+    bool misused = decomp_flags & TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF;
+    misused |= pOut_buf_next < pOut_buf_start || outOffset + *pOut_buf_size > TINFL_LZ_DICT_SIZE;
+    misused |= r->state != 0 && (pOut_buf_start != r->window || outOffset != r->windowPos);
+    if (misused || r->state == 2) {
+        fprintf(stderr, "tinfl: output at %zu (%zu bytes), expected %zu of the same window\n", outOffset, *pOut_buf_size, r->windowPos);
+        *pIn_buf_size = *pOut_buf_size = 0;
+        return TINFL_STATUS_BAD_PARAM;
+    }
+    if (r->state == 0) {
+        if (inflateInit2(&r->z, decomp_flags & TINFL_FLAG_PARSE_ZLIB_HEADER ? 15 : -15) != Z_OK) {
+            return TINFL_STATUS_FAILED;
+        }
+        r->state = 1;
+        r->window = pOut_buf_start;
+    }
+    r->z.next_in = (Bytef *) pIn_buf_next;
+    r->z.avail_in = *pIn_buf_size;
+    r->z.next_out = pOut_buf_next;
+    r->z.avail_out = *pOut_buf_size;
+    int result = inflate(&r->z, Z_NO_FLUSH);
+    *pIn_buf_size -= r->z.avail_in;
+    *pOut_buf_size -= r->z.avail_out;
+    r->windowPos = (outOffset + *pOut_buf_size) & (TINFL_LZ_DICT_SIZE - 1);
+    if (result == Z_STREAM_END) {
+        return tinfl_finish(r, TINFL_STATUS_DONE);
+    }
+    if (result != Z_OK && result != Z_BUF_ERROR) {
+        return tinfl_finish(r, TINFL_STATUS_FAILED);
+    }
+    if (r->z.avail_out == 0) {
+        return TINFL_STATUS_HAS_MORE_OUTPUT;
+    }
+    if (!(decomp_flags & TINFL_FLAG_HAS_MORE_INPUT)) {
+        return tinfl_finish(r, TINFL_STATUS_FAILED_CANNOT_MAKE_PROGRESS);
+    }
+    return TINFL_STATUS_NEEDS_MORE_INPUT;
+}
+
+#endif
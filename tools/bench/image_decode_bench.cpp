@@ -0,0 +1,145 @@
+// Host benchmark for drawing the embedded images: packed RGB565 (PackedImage) against the JPEGs (TJpgDec).
+// Decodes every image at every packed scale, checks the packed output against the reference pixels from
+// tools/pack_images.py and compares decode time and flash size.
+// Build and run with tools/bench/run_image_bench.sh
+
+#include "PackedImage.h"
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "tjpgd.h"
+}
+
+static std::vector<unsigned char> readFile(const std::string &path) {
+    std::vector<unsigned char> data;
+    FILE *f = fopen(path.c_str(), "rb");
+    if (!f) {
+        return data;
+    }
+    int c;
+    while ((c = fgetc(f)) != EOF) {
+        data.push_back(c);
+    }
+    fclose(f);
+    return data;
+}
+
+// Best of several rounds to filter out scheduler noise
+template <typename F>
+static double measure(int iterations, F decode) {
+    double best = 0;
+    for (int round = 0; round < 5; round++) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++) {
+            decode();
+        }
+        auto end = std::chrono::steady_clock::now();
+        double us = std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+        if (round == 0 || us < best) {
+            best = us;
+        }
+    }
+    return best;
+}
+
+static uint16_t framebuffer[240 * 240];
+
+struct JpegSource {
+    const unsigned char *data;
+    size_t size;
+    size_t pos;
+};
+
+static size_t jpegInput(JDEC *jdec, uint8_t *buf, size_t len) {
+    JpegSource *src = (JpegSource *) jdec->device;
+    len = std::min(len, src->size - src->pos);
+    if (buf) {
+        memcpy(buf, src->data + src->pos, len);
+    }
+    src->pos += len;
+    return len;
+}
+
+static int jpegOutput(JDEC *jdec, void *bitmap, JRECT *rect) {
+    int w = rect->right - rect->left + 1;
+    uint16_t *pixels = (uint16_t *) bitmap;
+    for (int y = rect->top; y <= rect->bottom; y++) {
+        memcpy(&framebuffer[y * 240 + rect->left], pixels, w * sizeof(uint16_t));
+        pixels += w;
+    }
+    return 1;
+}
+
+// Same as TJpgDec.drawJpg() with setJpgScale(scale)
+static bool decodeJpeg(const std::vector<unsigned char> &jpeg, int scale) {
+    static uint8_t work[3100];
+    JDEC jdec;
+    JpegSource src = {jpeg.data(), jpeg.size(), 0};
+    if (jd_prepare(&jdec, jpegInput, work, sizeof(work), &src) != JDR_OK) {
+        return false;
+    }
+    int shift = scale == 8 ? 3 : scale == 4 ? 2 : scale == 2 ? 1 : 0;
+    return jd_decomp(&jdec, jpegOutput, shift) == JDR_OK;
+}
+
+// Arguments: iterations, packed directory, then the image paths relative to images/ (without .jpg)
+int main(int argc, char **argv) {
+    if (argc < 4) {
+        fprintf(stderr, "Usage: %s iterations packed-dir image...\n", argv[0]);
+        return 1;
+    }
+    const int iterations = atoi(argv[1]);
+    const std::string packedDir = argv[2];
+    size_t jpegTotal = 0, packedTotal = 0;
+    int errors = 0;
+
+    printf("%-42s %5s %9s %9s %12s %12s\n", "image", "scale", "JPEG B", "packed B", "JPEG us", "packed us");
+    for (int arg = 3; arg < argc; arg++) {
+        std::string name = argv[arg];
+        std::vector<unsigned char> jpeg = readFile("images/" + name + ".jpg");
+        std::vector<unsigned char> packed = readFile(packedDir + "/" + name + ".pimg");
+        if (jpeg.empty() || !PackedImage::isPacked(packed.data(), packed.size())) {
+            fprintf(stderr, "Cannot read %s (run from the repository root)\n", name.c_str());
+            return 1;
+        }
+        jpegTotal += jpeg.size();
+        packedTotal += packed.size();
+
+        for (int scale = 1; scale <= 8; scale *= 2) {
+            uint16_t w, h;
+            if (!PackedImage::getSize(packed.data(), packed.size(), scale, &w, &h)) {
+                continue;
+            }
+
+            // Compare with the reference pixels (byte swapped like the firmware pushes them)
+            std::vector<unsigned char> reference = readFile(packedDir + "/" + name + ".s" + std::to_string(scale) + ".rgb565");
+            int mismatches = 0;
+            PackedImage::draw(0, 0, packed.data(), packed.size(), scale, [&](int16_t x, int16_t y, uint16_t bw, uint16_t bh, uint16_t *pixels) {
+                for (int i = 0; i < bw * bh; i++) {
+                    size_t pos = ((y * w) + i) * 2;
+                    uint16_t expected = pos + 1 < reference.size() ? (reference[pos] << 8) | reference[pos + 1] : 0;
+                    mismatches += pixels[i] != expected;
+                }
+                return true;
+            });
+            if (mismatches) {
+                fprintf(stderr, "%s scale %d: %d pixels differ from the reference\n", name.c_str(), scale, mismatches);
+                errors++;
+            }
+
+            double packedUs = measure(iterations, [&]() {
+                PackedImage::draw(0, 0, packed.data(), packed.size(), scale, [](int16_t x, int16_t y, uint16_t bw, uint16_t bh, uint16_t *pixels) {
+                    memcpy(&framebuffer[y * 240], pixels, bw * bh * sizeof(uint16_t));
+                    return true;
+                });
+            });
+            double jpegUs = measure(iterations, [&]() { decodeJpeg(jpeg, scale); });
+            printf("%-42s %5d %9zu %9zu %12.1f %12.1f\n", name.c_str(), scale, jpeg.size(), packed.size(), jpegUs, packedUs);
+        }
+    }
+    printf("Total flash: %zu bytes JPEG, %zu bytes packed\n", jpegTotal, packedTotal);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,179 @@
+// Host benchmark for InflateStream, the decompression of gzip and zlib API responses while they are parsed.
+// Reads every body through the stream with different network chunk sizes and read patterns and checks the
+// output against the plain file. The bodies are larger than the 32 KB window, so the output wraps around it
+// many times and back references reach across the wrap (tools/bench/host/rom/miniz.h checks the tinfl calls).
+// Build and run with tools/bench/run_inflate_bench.sh
+
+#include "InflateStream.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+static std::vector<unsigned char> readFile(const std::string &path) {
+    std::vector<unsigned char> data;
+    FILE *f = fopen(path.c_str(), "rb");
+    if (!f) {
+        return data;
+    }
+    int c;
+    while ((c = fgetc(f)) != EOF) {
+        data.push_back(c);
+    }
+    fclose(f);
+    return data;
+}
+
+// A response body that arrives in chunks of at most chunk bytes, like the TLS records of a connection
+class MemStream : public Stream {
+public:
+    MemStream(const std::vector<unsigned char> &data, size_t chunk) : m_data(data), m_chunk(chunk) {}
+
+    int available() override {
+        return std::min(m_chunk, m_data.size() - m_pos);
+    }
+    int read() override {
+        return m_pos < m_data.size() ? m_data[m_pos++] : -1;
+    }
+    int peek() override {
+        return m_pos < m_data.size() ? m_data[m_pos] : -1;
+    }
+    size_t readBytes(char *buffer, size_t length) override {
+        size_t count = std::min(length, m_data.size() - m_pos);
+        memcpy(buffer, m_data.data() + m_pos, count);
+        m_pos += count;
+        return count;
+    }
+    size_t write(uint8_t) override {
+        return 0;
+    }
+
+private:
+    const std::vector<unsigned char> &m_data;
+    size_t m_chunk;
+    size_t m_pos = 0;
+};
+
+enum ReadMode {
+    READ_BYTES, // deserializeJson() with ReadBufferingStream
+    READ_SINGLE, // deserializeJson() straight from the stream
+    PEEK_READ, // available() and peek() before every read()
+};
+
+static const char *MODE_NAMES[] = {"readBytes", "read", "peek"};
+
+static std::vector<unsigned char> inflate(const std::vector<unsigned char> &body, size_t chunk, ReadMode mode) {
+    std::vector<unsigned char> out;
+    MemStream source(body, chunk);
+    InflateStream stream;
+    HTTPClient http;
+    stream.prepare(http);
+    stream.begin(source);
+    if (mode == READ_BYTES) {
+        // Varying sizes, so reads end anywhere in the window
+        char buffer[700];
+        size_t length = 1;
+        size_t count;
+        while ((count = stream.readBytes(buffer, length)) > 0) {
+            out.insert(out.end(), buffer, buffer + count);
+            length = length * 7 % sizeof(buffer) + 1;
+        }
+    } else {
+        while (true) {
+            if (mode == PEEK_READ) {
+                int peeked = stream.peek();
+                if (peeked >= 0 && stream.available() <= 0) {
+                    fprintf(stderr, "peek() returned data, but available() is %d\n", stream.available());
+                    break;
+                }
+                if (peeked != stream.peek()) {
+                    fprintf(stderr, "peek() moved on\n");
+                    break;
+                }
+            }
+            int c = stream.read();
+            if (c < 0) {
+                break;
+            }
+            out.push_back(c);
+        }
+    }
+    return out;
+}
+
+// Arguments: iterations, directory with plain.json and the encoded bodies
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s iterations body-dir\n", argv[0]);
+        return 1;
+    }
+    const int iterations = atoi(argv[1]);
+    const std::string dir = argv[2];
+    std::vector<unsigned char> plain = readFile(dir + "/plain.json");
+    if (plain.size() < 4 * TINFL_LZ_DICT_SIZE) {
+        fprintf(stderr, "%s/plain.json is missing or too small to wrap around the window\n", dir.c_str());
+        return 1;
+    }
+    int errors = 0;
+
+    HTTPClient http;
+    InflateStream prepared;
+    prepared.prepare(http);
+    if (!http.m_http10 || http.m_headers.find("Accept-Encoding: gzip, deflate") == std::string::npos) {
+        fprintf(stderr, "prepare() did not ask for a compressed HTTP/1.0 response\n");
+        errors++;
+    }
+
+    // plain.json is passed through, the others are inflated
+    const char *bodies[] = {"plain.json", "body.gz", "body.zz", "body_header.gz"};
+    const size_t chunks[] = {1, 7, 100, 512, 1460, 16384};
+    printf("%-16s %9s %12s\n", "body", "bytes", "MB/s");
+    for (const char *name : bodies) {
+        std::vector<unsigned char> body = readFile(dir + "/" + name);
+        if (body.empty()) {
+            fprintf(stderr, "Cannot read %s/%s\n", dir.c_str(), name);
+            return 1;
+        }
+        for (size_t chunk : chunks) {
+            for (int mode = READ_BYTES; mode <= PEEK_READ; mode++) {
+                if (inflate(body, chunk, (ReadMode) mode) != plain) {
+                    fprintf(stderr, "%s: output differs (chunks of %zu, %s)\n", name, chunk, MODE_NAMES[mode]);
+                    errors++;
+                }
+            }
+        }
+
+        // Best of several rounds, through readBytes() with network sized chunks
+        double best = 0;
+        for (int round = 0; round < 5; round++) {
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; i++) {
+                inflate(body, 1460, READ_BYTES);
+            }
+            auto end = std::chrono::steady_clock::now();
+            double us = std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+            if (round == 0 || us < best) {
+                best = us;
+            }
+        }
+        printf("%-16s %9zu %12.1f\n", name, body.size(), plain.size() / best);
+    }
+
+    // A connection that drops in the middle: the output so far, then the end of the stream
+    std::vector<unsigned char> truncated = readFile(dir + "/body.gz");
+    truncated.resize(truncated.size() / 2);
+    std::vector<unsigned char> partial = inflate(truncated, 1460, READ_BYTES);
+    if (partial.empty() || partial.size() >= plain.size() || memcmp(partial.data(), plain.data(), partial.size()) != 0) {
+        fprintf(stderr, "Truncated body: %zu bytes that are not the start of the plain body\n", partial.size());
+        errors++;
+    }
+
+    // Not JSON, not gzip and not zlib: passed through untouched
+    std::vector<unsigned char> other = {'x', 'y', 'z'};
+    if (inflate(other, 1, READ_SINGLE) != other) {
+        fprintf(stderr, "Unknown body was not passed through\n");
+        errors++;
+    }
+
+    printf(errors ? "%d errors\n" : "All bodies match\n", errors);
+    return errors ? 1 : 0;
+}
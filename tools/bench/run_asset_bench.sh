@@ -0,0 +1,15 @@
+#!/bin/sh
+# Packs the asset store like the esp32doit-devkit-v1-assets environment does and runs the asset store benchmark on it.
+# Usage: tools/bench/run_asset_bench.sh [iterations]   (run from the repository root, needs Pillow and fontTools)
+set -e
+
+OUT=${TMPDIR:-/tmp}/info-orbs-asset-bench
+mkdir -p "$OUT"
+
+python3 tools/pack_assets.py "$OUT/assets.bin"
+ASSETS=$(sed -n '/^board_build.embed_files/,/^board_build.partitions/p' platformio.ini | sed 's/;.*//' | grep -E '^\s+(fonts|images)/' | tr -d '\t ')
+
+c++ -std=c++17 -O2 -w -DASSET_STORE -Itools/bench/host -Ifirmware/include -Ifirmware/src/core/assetstore -Ifirmware/src/core/screenmanager \
+    -o "$OUT/asset_store_bench" tools/bench/asset_store_bench.cpp firmware/src/core/assetstore/AssetStore.cpp firmware/src/core/screenmanager/PackedImage.cpp
+
+ASSET_STORE_FILE="$OUT/assets.bin" "$OUT/asset_store_bench" "${1:-100000}" $ASSETS
@@ -0,0 +1,46 @@
+#!/bin/sh
+# Packs every JPEG in images/ like tools/pack_images.py does for the firmware and runs the image decode benchmark.
+# The JPEG side uses the TJpgDec sources of the firmware build (or TJPGD_DIR=path/to/TJpg_Decoder/src).
+# Usage: tools/bench/run_image_bench.sh [iterations]   (run from the repository root, needs Pillow and PlatformIO)
+set -e
+
+OUT=${TMPDIR:-/tmp}/info-orbs-image-bench
+mkdir -p "$OUT"
+
+# Pack all images (weather icons also at 1/4 like the forecast) and keep the reference pixels for checking
+IMAGES=$(cd images && find . -name '*.jpg' ! -path './packed/*' | sed 's|^\./||; s|\.jpg$||' | sort)
+python3 - "$OUT/packed" $IMAGES <<'EOF'
+import os, struct, sys
+sys.path.insert(0, "tools")
+import pack_images
+out = sys.argv[1]
+for name in sys.argv[2:]:
+    scales = [1, 4] if name.startswith("WeatherWidget/") else [1]
+    os.makedirs(os.path.dirname(os.path.join(out, name)), exist_ok=True)
+    with open(os.path.join(out, name + ".pimg"), "wb") as f:
+        f.write(pack_images.pack_image(os.path.join("images", name + ".jpg"), scales))
+    for scale in scales:
+        pixels = pack_images.load_rgb565(os.path.join("images", name + ".jpg"), scale)[2]
+        with open(os.path.join(out, f"{name}.s{scale}.rgb565"), "wb") as f:
+            f.write(struct.pack(f"<{len(pixels)}H", *pixels))
+EOF
+
+# The TJpgDec version the firmware links (lib_deps in platformio.ini), fetched by PlatformIO if no build did it yet
+if [ -z "$TJPGD_DIR" ]; then
+    TJPGD_DIR=$(dirname "$(find .pio/libdeps "$OUT/lib" -name tjpgd.c 2>/dev/null | head -n 1)")
+fi
+if [ ! -f "$TJPGD_DIR/tjpgd.c" ]; then
+    TJPGD_LIB=$(grep -o 'bodmer/TJpg_Decoder@[^ ]*' platformio.ini | head -n 1)
+    pio pkg install --library "$TJPGD_LIB" --storage-dir "$OUT/lib" >/dev/null || true
+    TJPGD_DIR=$(dirname "$(find "$OUT/lib" -name tjpgd.c 2>/dev/null | head -n 1)")
+fi
+if [ ! -f "$TJPGD_DIR/tjpgd.c" ]; then
+    echo "TJpgDec not found and PlatformIO cannot fetch it, set TJPGD_DIR to the TJpg_Decoder/src directory" >&2
+    exit 1
+fi
+cc -O2 -w -I"$TJPGD_DIR" -c "$TJPGD_DIR/tjpgd.c" -o "$OUT/tjpgd.o"
+
+c++ -std=c++17 -O2 -w -Itools/bench/host -Ifirmware/src/core/screenmanager -I"$TJPGD_DIR" -o "$OUT/image_decode_bench" \
+    tools/bench/image_decode_bench.cpp firmware/src/core/screenmanager/PackedImage.cpp "$OUT/tjpgd.o"
+
+"$OUT/image_decode_bench" "${1:-200}" "$OUT/packed" $IMAGES
@@ -0,0 +1,38 @@
+#!/bin/sh
+# Writes an API response larger than the inflate window in every encoding and runs the InflateStream benchmark on it.
+# tinfl comes from the ESP32 ROM, so the host build emulates it with zlib (tools/bench/host/rom/miniz.h).
+# Usage: tools/bench/run_inflate_bench.sh [iterations]   (run from the repository root, needs the zlib headers)
+set -e
+
+OUT=${TMPDIR:-/tmp}/info-orbs-inflate-bench
+mkdir -p "$OUT"
+
+# A forecast like the weather APIs send, the repeated days at the end make back references of almost the whole window
+python3 - "$OUT" <<'EOF'
+import gzip, json, random, struct, sys, zlib
+out = sys.argv[1]
+random.seed(1)
+conditions = ["clear-day", "partly-cloudy-day", "cloudy", "rain", "snow", "fog", "wind"]
+days = [{"datetime": f"2024-{1 + i // 28 % 12:02d}-{1 + i % 28:02d}", "tempmax": round(random.uniform(-10, 35), 1),
+         "tempmin": round(random.uniform(-20, 20), 1), "precipprob": random.randint(0, 100),
+         "icon": random.choice(conditions), "description": " ".join(random.choices(conditions, k=random.randint(1, 6)))}
+        for i in range(1500)]
+plain = json.dumps({"timezone": "Europe/Berlin", "days": days[:1500] + days[1400:1500]}).encode()
+with open(f"{out}/plain.json", "wb") as f:
+    f.write(plain)
+with open(f"{out}/body.gz", "wb") as f:
+    f.write(gzip.compress(plain))
+with open(f"{out}/body.zz", "wb") as f:
+    f.write(zlib.compress(plain))
+# Every optional gzip header field: extra, name, comment and header CRC
+deflate = zlib.compressobj(9, zlib.DEFLATED, -15)
+header = b"\x1f\x8b\x08\x1e" + bytes(6) + struct.pack("<H", 5) + b"extra" + b"resp.json\0" + b"comment\0"
+with open(f"{out}/body_header.gz", "wb") as f:
+    f.write(header + struct.pack("<H", zlib.crc32(header) & 0xFFFF) + deflate.compress(plain) + deflate.flush()
+            + struct.pack("<II", zlib.crc32(plain), len(plain)))
+EOF
+
+c++ -std=c++17 -O2 -w -Itools/bench/host -Ifirmware/src/core/utils -o "$OUT/inflate_stream_bench" \
+    tools/bench/inflate_stream_bench.cpp firmware/src/core/utils/InflateStream.cpp -lz
+
+"$OUT/inflate_stream_bench" "${1:-20}" "$OUT"
@@ -0,0 +1,20 @@
+#!/bin/sh
+# Builds the vendored OpenFontRender/FreeType for the host and runs the text rendering benchmark.
+# Usage: tools/bench/run_text_bench.sh [iterations] [glyph cache bytes]   (run from the repository root)
+# OFR_DIR=path/to/OpenFontRender measures another copy of the library, e.g. an older revision for a baseline.
+set -e
+
+LIB=${OFR_DIR:-firmware/lib/OpenFontRender}
+OUT=${TMPDIR:-/tmp}/info-orbs-text-bench
+# FreeType objects per library copy
+OBJ="$OUT/$(echo "$LIB" | tr '/' '_')"
+mkdir -p "$OBJ"
+
+for src in $(find "$LIB" -name '*.c'); do
+    obj="$OBJ/$(echo "$src" | tr '/' '_').o"
+    [ "$obj" -nt "$src" ] || cc -O2 -w -I"$LIB" -c "$src" -o "$obj"
+done
+c++ -std=c++17 -O2 -w -I"$LIB" -o "$OUT/text_render_bench" \
+    tools/bench/text_render_bench.cpp "$LIB/OpenFontRender.cpp" "$LIB/FileSupport.cpp" "$LIB/base/ftsystem.cpp" "$OBJ"/*.o
+
+"$OUT/text_render_bench" "$@"
@@ -0,0 +1,127 @@
+// Host benchmark for OpenFontRender text rendering (glyph rasterization, blending and span output).
+// Renders the strings ClockWidget and WeatherWidget draw, at the sizes they use, into a 240x240 RGB565 buffer.
+// Build and run with tools/bench/run_text_bench.sh
+
+#include "OpenFontRender.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+static const int SCREEN_SIZE = 240;
+static uint16_t framebuffer[SCREEN_SIZE * SCREEN_SIZE];
+
+struct Case {
+    const char *font;
+    unsigned int size; // Already scaled like ScreenManager::getScaledFontSize()
+    const char *text;
+};
+
+// Roboto sizes are scaled by 1.37 (see ttf-fonts.h), DSEG7 is not scaled
+static const Case CASES[] = {
+    {"fonts/DSEG7ModernBold.ttf", 200, "8"},   // ClockWidget digit (CLOCK_FONT_SIZE)
+    {"fonts/RobotoRegular.ttf", 90, "12:34"},  // WeatherWidget clock (66)
+    {"fonts/RobotoRegular.ttf", 121, "23°"},   // WeatherWidget current temperature (88)
+    {"fonts/RobotoRegular.ttf", 30, "Wednesday"},  // WeatherWidget weekday (22)
+    {"fonts/RobotoRegular.ttf", 25, "September 30"}, // WeatherWidget date (18)
+    {"fonts/RobotoRegular.ttf", 21, "Partly cloudy throughout the day"}, // WeatherWidget description (15)
+};
+
+static std::vector<unsigned char> readFile(const char *path) {
+    std::vector<unsigned char> data;
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "Cannot open %s (run from the repository root)\n", path);
+        exit(1);
+    }
+    int c;
+    while ((c = fgetc(f)) != EOF) {
+        data.push_back(c);
+    }
+    fclose(f);
+    return data;
+}
+
+static void clip(int32_t &x, int32_t y, int32_t &w, int32_t &offset) {
+    offset = 0;
+    if (y < 0 || y >= SCREEN_SIZE) {
+        w = 0;
+        return;
+    }
+    if (x < 0) {
+        offset = -x;
+        w += x;
+        x = 0;
+    }
+    if (x + w > SCREEN_SIZE) {
+        w = SCREEN_SIZE - x;
+    }
+}
+
+// Best of several rounds to filter out scheduler noise, in us per string
+template <typename F>
+static double measure(int iterations, F draw) {
+    double best = 0;
+    for (int round = 0; round < 5; round++) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++) {
+            draw(i);
+        }
+        auto end = std::chrono::steady_clock::now();
+        double us = std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+        if (round == 0 || us < best) {
+            best = us;
+        }
+    }
+    return best;
+}
+
+int main(int argc, char **argv) {
+    const int iterations = argc > 1 ? atoi(argv[1]) : 200;
+    // Default matches ScreenManager, pass a bigger value to measure drawing without glyph cache misses
+    const unsigned long cacheBytes = argc > 2 ? atol(argv[2]) : 8192;
+
+    printf("%-28s %5s %-34s %12s %12s\n", "font", "size", "text", "fixed us", "altern. us");
+    for (const Case &c : CASES) {
+        std::vector<unsigned char> font = readFile(c.font);
+        OpenFontRender render;
+        // Same drawing callbacks as ScreenManager
+        render.setCacheSize(128, 128, cacheBytes);
+        render.set_drawPixel([](int32_t x, int32_t y, uint16_t color) {
+            if (x >= 0 && x < SCREEN_SIZE && y >= 0 && y < SCREEN_SIZE) {
+                framebuffer[y * SCREEN_SIZE + x] = color;
+            }
+        });
+        render.set_drawFastHLine([](int32_t x, int32_t y, int32_t w, uint16_t color) {
+            int32_t offset;
+            clip(x, y, w, offset);
+            for (int32_t i = 0; i < w; i++) {
+                framebuffer[y * SCREEN_SIZE + x + i] = color;
+            }
+        });
+        render.set_drawHSpan([](int32_t x, int32_t y, int32_t w, uint16_t *colors) {
+            int32_t offset;
+            clip(x, y, w, offset);
+            if (w > 0) {
+                memcpy(&framebuffer[y * SCREEN_SIZE + x], colors + offset, w * sizeof(uint16_t));
+            }
+        });
+        render.setAlignToInk(true);
+        if (render.loadFont(font.data(), font.size())) {
+            fprintf(stderr, "Cannot load %s\n", c.font);
+            return 1;
+        }
+        render.setFontSize(c.size);
+        render.setAlignment(Align::MiddleCenter);
+
+        // Warm up the glyph cache, like a widget that redraws the same text
+        render.drawString(c.text, 120, 120, 0xFFFF, 0x0000);
+
+        // Fixed colors like most widgets draw, and alternating ones (dimming, inverted widgets) that rebuild the blend table
+        double fixedUs = measure(iterations, [&](int) { render.drawString(c.text, 120, 120, 0xFFFF, 0x0000); });
+        double alternatingUs = measure(iterations, [&](int i) { render.drawString(c.text, 120, 120, (i & 1) ? 0xFFFF : 0xF800, 0x0000); });
+        printf("%-28s %5u %-34s %12.1f %12.1f\n", strrchr(c.font, '/') + 1, c.size, c.text, fixedUs, alternatingUs);
+        render.unloadFont();
+    }
+    return 0;
+}
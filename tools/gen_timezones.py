@@ -0,0 +1,56 @@
+#!/usr/bin/env python3
+"""Generate firmware/src/core/globaltime/TimeZones.h from the host tzdata.
+
+Every TZif (v2+) file ends with a POSIX TZ string describing the current
+rules of the zone. We collect these for all canonical zones into a sorted
+table, so the firmware can look up TIMEZONE_API_LOCATION and evaluate the
+offset and DST transitions locally.
+
+Usage: python3 tools/gen_timezones.py [zoneinfo dir]
+Rerun whenever tzdata changes rules (a few times a year at most).
+"""
+
+import os
+import sys
+
+ZONEINFO = sys.argv[1] if len(sys.argv) > 1 else "/usr/share/zoneinfo"
+OUTPUT = os.path.join(os.path.dirname(__file__), "..", "firmware", "src", "core", "globaltime", "TimeZones.h")
+REGIONS = ("Africa", "America", "Antarctica", "Arctic", "Asia", "Atlantic", "Australia", "Europe", "Indian", "Pacific")
+
+
+def posix_tz(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if not data.startswith(b"TZif") or data[4:5] < b"2":
+        return None
+    footer = data.rstrip(b"\n").rsplit(b"\n", 1)[-1].decode("ascii")
+    return footer or None
+
+
+def main():
+    zones = {}
+    for region in REGIONS:
+        for root, _, files in os.walk(os.path.join(ZONEINFO, region)):
+            for name in files:
+                path = os.path.join(root, name)
+                tz = posix_tz(path)
+                if tz:
+                    zones[os.path.relpath(path, ZONEINFO).replace(os.sep, "/")] = tz
+    # Fixed offset zones for anyone who doesn't want DST at all
+    zones["UTC"] = "UTC0"
+
+    with open(OUTPUT, "w", newline="\n") as out:
+        out.write("#ifndef TIMEZONES_H\n#define TIMEZONES_H\n\n")
+        out.write("// Generated by tools/gen_timezones.py - do not edit\n")
+        out.write("// IANA zone name -> POSIX TZ rule, sorted by name for binary search\n\n")
+        out.write("struct TimeZoneEntry {\n    const char *name;\n    const char *rule;\n};\n\n")
+        out.write("const TimeZoneEntry TIME_ZONES[] = {\n")
+        for name in sorted(zones):
+            out.write(f'    {{"{name}", "{zones[name]}"}},\n')
+        out.write("};\n\n")
+        out.write("const int TIME_ZONE_COUNT = sizeof(TIME_ZONES) / sizeof(TIME_ZONES[0]);\n\n#endif\n")
+    print(f"Wrote {len(zones)} zones to {os.path.normpath(OUTPUT)}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,221 @@
+// Generates firmware/src/core/screenmanager/GlyphPacks.h: pre-rasterized glyphs for fixed font sizes,
+// drawn by ScreenManager without FreeType when GLYPH_PACKS is defined (see GlyphPack.h).
+// The glyphs are rasterized with the vendored FreeType, exactly like OpenFontRender does on the device.
+// Build and run with tools/glyphpack/gen_glyph_packs.sh
+
+#include "ft2build.h"
+#include FT_FREETYPE_H
+#include FT_GLYPH_H
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct FontFile {
+    const char *name; // TTF_Font enum value
+    const char *path;
+};
+
+// Same files as board_build.embed_files, override with FONT=file (e.g. DSEG7=fonts/DSEG7ClassicBold.ttf)
+static const FontFile FONT_FILES[] = {
+    {"ROBOTO_REGULAR", "fonts/RobotoRegular.ttf"},
+    {"FINAL_FRONTIER", "fonts/FinalFrontier.ttf"},
+    {"DSEG7", "fonts/DSEG7ModernBold.ttf"},
+    {"DSEG14", "fonts/DSEG14ModernBold.ttf"},
+};
+
+// Printable ASCII and the degree sign
+static const char *DEFAULT_CHARS = " !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~°";
+
+struct Glyph {
+    uint16_t codepoint;
+    int width, height, left, top;
+    int inkLeft, inkRight, inkTop, inkBottom;
+    int bearing, advance;
+    size_t offset;
+};
+
+static std::vector<uint16_t> decodeUTF8(const char *str) {
+    std::vector<uint16_t> codepoints;
+    const uint8_t *p = (const uint8_t *) str;
+    while (*p) {
+        uint16_t c = *p++;
+        if ((c & 0xE0) == 0xC0 && *p) {
+            c = ((c & 0x1F) << 6) | (*p++ & 0x3F);
+        } else if ((c & 0xF0) == 0xE0 && p[0] && p[1]) {
+            c = ((c & 0x0F) << 12) | ((p[0] & 0x3F) << 6) | (p[1] & 0x3F);
+            p += 2;
+        }
+        bool known = false;
+        for (uint16_t k : codepoints) {
+            known |= k == c;
+        }
+        if (!known) {
+            codepoints.push_back(c);
+        }
+    }
+    std::sort(codepoints.begin(), codepoints.end());
+    return codepoints;
+}
+
+static uint8_t quantize(uint8_t alpha) {
+    uint8_t level = (alpha + 8) / 17;
+    return alpha && !level ? 1 : level;
+}
+
+static void fail(const char *message, const char *arg) {
+    fprintf(stderr, "gen_glyph_packs: %s %s\n", message, arg);
+    exit(1);
+}
+
+static std::vector<FT_Byte> readFile(const char *path) {
+    std::vector<FT_Byte> data;
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        fail("cannot open (run from the repository root)", path);
+    }
+    int c;
+    while ((c = fgetc(f)) != EOF) {
+        data.push_back(c);
+    }
+    fclose(f);
+    return data;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: gen_glyph_packs FONT[=file]:SIZE[:CHARS]... > GlyphPacks.h\n");
+        return 1;
+    }
+
+    FT_Library library;
+    if (FT_Init_FreeType(&library)) {
+        fail("cannot initialize", "FreeType");
+    }
+
+    printf("#ifndef GLYPHPACKS_H\n#define GLYPHPACKS_H\n\n");
+    printf("// Generated by tools/glyphpack/gen_glyph_packs.sh - do not edit\n//");
+    for (int i = 1; i < argc; i++) {
+        printf(" %s", argv[i]);
+    }
+    printf("\n\n#include \"GlyphPack.h\"\n\n");
+
+    std::string packs;
+    size_t totalBytes = 0;
+    for (int i = 1; i < argc; i++) {
+        // FONT[=file]:SIZE[:CHARS]
+        std::string spec = argv[i];
+        size_t sizeSep = spec.find(':');
+        if (sizeSep == std::string::npos) {
+            fail("missing size in", argv[i]);
+        }
+        std::string font = spec.substr(0, sizeSep);
+        std::string path;
+        size_t fileSep = font.find('=');
+        if (fileSep != std::string::npos) {
+            path = font.substr(fileSep + 1);
+            font = font.substr(0, fileSep);
+        } else {
+            for (const FontFile &file : FONT_FILES) {
+                if (font == file.name) {
+                    path = file.path;
+                }
+            }
+        }
+        if (path.empty()) {
+            fail("unknown font", font.c_str());
+        }
+        size_t charsSep = spec.find(':', sizeSep + 1);
+        int size = atoi(spec.substr(sizeSep + 1, charsSep - sizeSep - 1).c_str());
+        std::vector<uint16_t> codepoints = decodeUTF8(charsSep == std::string::npos ? DEFAULT_CHARS : spec.c_str() + charsSep + 1);
+
+        // Kept until the face is done
+        std::vector<FT_Byte> data = readFile(path.c_str());
+        FT_Face face;
+        if (FT_New_Memory_Face(library, data.data(), data.size(), 0, &face)) {
+            fail("cannot load", path.c_str());
+        }
+        // Same as the FTC scaler OpenFontRender uses (pixel height, width 0)
+        FT_Set_Pixel_Sizes(face, 0, size);
+        int ascender = face->size->metrics.ascender >> 6;
+
+        std::vector<Glyph> glyphs;
+        std::vector<uint8_t> bitmaps;
+        for (uint16_t codepoint : codepoints) {
+            FT_UInt index = FT_Get_Char_Index(face, codepoint);
+            if (index == 0) {
+                fprintf(stderr, "gen_glyph_packs: %s has no glyph for U+%04X, skipped\n", path.c_str(), codepoint);
+                continue;
+            }
+            Glyph glyph = {};
+            glyph.codepoint = codepoint;
+
+            // Outline metrics, used by OpenFontRender for the alignment
+            FT_Glyph outline;
+            FT_BBox box;
+            FT_Load_Glyph(face, index, FT_LOAD_DEFAULT);
+            glyph.bearing = face->glyph->metrics.horiBearingX >> 6;
+            FT_Get_Glyph(face->glyph, &outline);
+            FT_Glyph_Get_CBox(outline, FT_GLYPH_BBOX_PIXELS, &box);
+            glyph.inkLeft = box.xMin;
+            glyph.inkRight = box.xMax;
+            glyph.inkTop = box.yMax;
+            glyph.inkBottom = box.yMin;
+            glyph.advance = outline->advance.x >> 16;
+            FT_Done_Glyph(outline);
+
+            // Anti-aliased bitmap, quantized to 4 bit (any coverage stays visible) and run length encoded per row:
+            // every byte is a run of (low nibble + 1) pixels with the alpha level in the high nibble
+            FT_Load_Glyph(face, index, FT_LOAD_RENDER);
+            FT_Bitmap &bitmap = face->glyph->bitmap;
+            if (bitmap.width > 255 || bitmap.rows > 255) {
+                fail("glyph too big (max 255x255 pixels) in", argv[i]);
+            }
+            glyph.width = bitmap.width;
+            glyph.height = bitmap.rows;
+            glyph.left = face->glyph->bitmap_left;
+            glyph.top = face->glyph->bitmap_top;
+            glyph.offset = bitmaps.size();
+            for (int y = 0; y < glyph.height; y++) {
+                int x = 0;
+                while (x < glyph.width) {
+                    uint8_t level = quantize(bitmap.buffer[y * bitmap.pitch + x]);
+                    int run = 1;
+                    while (run < 16 && x + run < glyph.width && quantize(bitmap.buffer[y * bitmap.pitch + x + run]) == level) {
+                        run++;
+                    }
+                    bitmaps.push_back((level << 4) | (run - 1));
+                    x += run;
+                }
+            }
+            glyphs.push_back(glyph);
+        }
+        FT_Done_Face(face);
+
+        std::string name = "PACK_" + font + "_" + std::to_string(size);
+        printf("const uint8_t %s_BITMAPS[] = {", name.c_str());
+        for (size_t b = 0; b < bitmaps.size(); b++) {
+            printf("%s0x%02X,", b % 16 ? " " : "\n    ", bitmaps[b]);
+        }
+        printf("\n    0x00};\n\n");
+        printf("const PackedGlyph %s_GLYPHS[] = {\n", name.c_str());
+        for (const Glyph &g : glyphs) {
+            printf("    {0x%04X, %d, %d, %d, %d, %d, %d, %d, %d, %d, %d, %zu},\n",
+                   g.codepoint, g.width, g.height, g.left, g.top, g.inkLeft, g.inkRight, g.inkTop, g.inkBottom, g.bearing, g.advance, g.offset);
+        }
+        printf("};\n\n");
+        packs += "    {" + font + ", " + std::to_string(size) + ", " + std::to_string(ascender) + ", " + std::to_string(glyphs.size()) + ", " + name + "_GLYPHS, " + name + "_BITMAPS},\n";
+
+        size_t bytes = bitmaps.size() + glyphs.size() * 24;
+        totalBytes += bytes;
+        fprintf(stderr, "%-16s %4d px %4zu glyphs %8zu bytes\n", font.c_str(), size, glyphs.size(), bytes);
+    }
+    printf("const GlyphPackData PACKED_FONTS[] = {\n%s};\n\n", packs.c_str());
+    printf("const int PACKED_FONT_COUNT = sizeof(PACKED_FONTS) / sizeof(PACKED_FONTS[0]);\n\n#endif\n");
+    fprintf(stderr, "Total %zu bytes of flash\n", totalBytes);
+
+    FT_Done_FreeType(library);
+    return 0;
+}
@@ -0,0 +1,21 @@
+#!/bin/sh
+# Builds the glyph pack generator against the vendored FreeType and writes firmware/src/core/screenmanager/GlyphPacks.h.
+# Sizes are the pixel sizes OpenFontRender gets, i.e. after ttfFontMetrics scaling (Roboto x1.37, Final Frontier x1.5).
+# Usage (from the repository root): tools/glyphpack/gen_glyph_packs.sh FONT[=file]:SIZE[:CHARS]...
+# Example: tools/glyphpack/gen_glyph_packs.sh DSEG7:200:0123456789 ROBOTO_REGULAR:25 ROBOTO_REGULAR:30
+# Then enable GLYPH_PACKS in config.h
+set -e
+
+LIB=firmware/lib/OpenFontRender
+OUT=${TMPDIR:-/tmp}/info-orbs-glyphpack
+mkdir -p "$OUT"
+
+for src in $(find "$LIB" -name '*.c'); do
+    obj="$OUT/$(echo "$src" | tr '/' '_').o"
+    [ "$obj" -nt "$src" ] || cc -O2 -w -I"$LIB" -c "$src" -o "$obj"
+done
+c++ -std=c++17 -O2 -w -I"$LIB" -o "$OUT/gen_glyph_packs" \
+    tools/glyphpack/gen_glyph_packs.cpp "$LIB/FileSupport.cpp" "$LIB/base/ftsystem.cpp" "$OUT"/*.o
+
+"$OUT/gen_glyph_packs" "$@" > "$OUT/GlyphPacks.h"
+mv "$OUT/GlyphPacks.h" firmware/src/core/screenmanager/GlyphPacks.h
@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+"""Pack the fonts and images into an image for the assets partition.
+
+With ASSET_STORE (see the esp32doit-devkit-v1-assets environment), the files in
+custom_assets are not linked into the app. They are written to the assets
+partition (partitions.csv) and memory mapped by AssetStore. Flash them once,
+and again whenever they change, with:
+  pio run -e esp32doit-devkit-v1-assets -t uploadassets
+The subset fonts and packed images are generated by tools/subset_fonts.py and
+tools/pack_images.py like for embedded files.
+
+Assets are named like the linker symbols of embedded files without "_binary_"
+(fonts/subset/RobotoRegular.ttf is "fonts_subset_RobotoRegular_ttf"), so the
+headers in firmware/include work for both. The layout is described in
+firmware/src/core/assetstore/AssetStore.cpp.
+
+Runs automatically as a PlatformIO pre-script, or manually (e.g. to test the
+store on the host with ASSET_STORE_FILE):
+Usage: python3 tools/pack_assets.py [output]
+"""
+
+import configparser
+import os
+import re
+import struct
+import sys
+
+ROOT = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(sys.argv[0])), ".."))
+VERSION = 1
+HEADER_SIZE = 16
+NAME_SIZE = 56
+ENTRY_SIZE = 64
+PARTITION = "assets"
+
+
+def asset_name(path):
+    # Same as the symbol names of board_build.embed_files
+    return re.sub(r"[^A-Za-z0-9]", "_", path)
+
+
+def pack_store(files):
+    assets = sorted((asset_name(f).encode(), f) for f in files)
+    offset = HEADER_SIZE + ENTRY_SIZE * len(assets)
+    index = bytearray()
+    data = bytearray()
+    for name, path in assets:
+        if len(name) >= NAME_SIZE:
+            sys.exit(f"pack_assets: name too long: {name.decode()}")
+        with open(os.path.join(ROOT, path), "rb") as f:
+            content = f.read()
+        index += name.ljust(NAME_SIZE, b"\0") + struct.pack("<II", offset + len(data), len(content))
+        data += content
+        data += b"\0" * (-len(data) % 4)
+    size = offset + len(data)
+    return b"ASST" + struct.pack("<HHII", VERSION, len(assets), size, 0) + bytes(index) + bytes(data)
+
+
+def partition(partitions_csv):
+    with open(os.path.join(ROOT, partitions_csv)) as f:
+        for line in f:
+            fields = [field.strip() for field in line.split("#")[0].split(",")]
+            if fields[0] == PARTITION:
+                return int(fields[3], 0), int(fields[4], 0)
+    sys.exit(f"pack_assets: no '{PARTITION}' partition in {partitions_csv}")
+
+
+def asset_files(option):
+    files = [line.split(";")[0].strip() for line in option.splitlines()]
+    return [f for f in files if f]
+
+
+def build(files, partitions_csv, output):
+    offset, size = partition(partitions_csv)
+    store = pack_store(files)
+    if len(store) > size:
+        sys.exit(f"pack_assets: {len(store)} bytes don't fit into the {size} bytes '{PARTITION}' partition")
+    os.makedirs(os.path.dirname(os.path.abspath(output)), exist_ok=True)
+    with open(output, "wb") as f:
+        f.write(store)
+    print(f"pack_assets: {len(files)} assets, {len(store)} of {size} bytes at {offset:#x}")
+    return offset
+
+
+def main():
+    config = configparser.ConfigParser(interpolation=None, inline_comment_prefixes=(";",))
+    config.read(os.path.join(ROOT, "platformio.ini"))
+    sys.path.insert(0, os.path.join(ROOT, "tools"))
+    import pack_images
+    import subset_fonts
+
+    # Everything the default environment embeds, generated first like the pre-scripts do
+    base = config[next(section for section in config.sections() if section.startswith("env:"))]
+    files = asset_files(base.get("board_build.embed_files", ""))
+    subset_fonts.ROOT = pack_images.ROOT = ROOT
+    subset_fonts.build(subset_fonts.embedded_fonts("\n".join(files)), base.get("custom_font_chars", ""))
+    pack_images.build(pack_images.embedded_images("\n".join(files)), base.get("custom_image_scales", ""))
+    output = sys.argv[1] if len(sys.argv) > 1 else os.path.join(ROOT, ".pio", "assets.bin")
+    build(files, base.get("board_build.partitions", "partitions.csv"), output)
+
+
+def upload(source, target, env):
+    env.AutodetectUploadPort()
+    env.Execute(f'"$PYTHONEXE" "$UPLOADER" --chip esp32 --port "$UPLOAD_PORT" --baud $UPLOAD_SPEED write_flash {env["ASSETS_OFFSET"]:#x} "$BUILD_DIR/assets.bin"')
+
+
+if __name__ == "__main__":
+    main()
+elif "Import" in globals():
+    # PlatformIO pre-script (no __file__ in SCons scripts), after subset_fonts.py and pack_images.py
+    Import("env")  # noqa: F821
+    ROOT = env.subst("$PROJECT_DIR")  # noqa: F821
+    files = asset_files(env.GetProjectOption("custom_assets", ""))  # noqa: F821
+    if files:
+        partitions_csv = env.GetProjectOption("board_build.partitions", "partitions.csv")  # noqa: F821
+        env["ASSETS_OFFSET"] = build(files, partitions_csv, env.subst("$BUILD_DIR/assets.bin"))  # noqa: F821
+        env.AddCustomTarget("uploadassets", None, upload, title="Upload Assets", description="Write the fonts and images to the assets partition")  # noqa: F821
@@ -0,0 +1,190 @@
+#!/usr/bin/env python3
+"""Convert the embedded JPEGs to pre-decoded RGB565 images.
+
+Every image in board_build.embed_files (or custom_assets) below images/packed/
+is generated from the JPEG with the same path below images/
+(images/packed/logo.pimg is made from images/logo.jpg). The firmware draws
+them with ScreenManager::drawImage(), which only has to expand the codes below
+instead of running the JPEG decoder.
+
+An image holds one variant per scale listed in custom_image_scales (1 = full
+size, 2, 4 or 8 = reduced like TJpgDec.setJpgScale()), so the small forecast
+icons don't have to be decoded from the full size image either.
+
+Every variant is compressed like QOI, on RGB565 pixels (the previous pixel
+starts as black, the index holds 64 recently seen pixels):
+  00iiiiii           pixel from index[i]
+  01rrggbb           previous pixel + (r - 2, g - 2, b - 2)
+  10gggggg rrrrbbbb  previous pixel + (dg + r - 8, dg, dg + b - 8), dg = g - 32
+  11nnnnnn           previous pixel, repeated n + 1 times (n < 62)
+  11111110 lo hi     RGB565 pixel
+Every pixel except runs is put into index[((pixel * 0x9E37) & 0xFFFF) >> 10].
+The header layout is described in firmware/src/core/screenmanager/PackedImage.cpp.
+
+Runs automatically as a PlatformIO pre-script, or manually:
+Usage: python3 tools/pack_images.py
+"""
+
+import configparser
+import os
+import struct
+import sys
+
+ROOT = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(sys.argv[0])), ".."))
+PACKED_DIR = "images/packed/"
+VERSION = 1
+
+
+def load_rgb565(source, scale):
+    from PIL import Image
+
+    image = Image.open(source).convert("RGB")
+    if scale > 1:
+        image = image.reduce(scale)
+    # Truncate like TJpgDec does
+    rgb = image.tobytes()
+    pixels = [((rgb[i] & 0xF8) << 8) | ((rgb[i + 1] & 0xFC) << 3) | (rgb[i + 2] >> 3) for i in range(0, len(rgb), 3)]
+    return image.width, image.height, pixels
+
+
+def hash_pixel(pixel):
+    return ((pixel * 0x9E37) & 0xFFFF) >> 10
+
+
+def split(pixel):
+    return pixel >> 11, (pixel >> 5) & 0x3F, pixel & 0x1F
+
+
+def encode(pixels):
+    out = bytearray()
+    index = [0] * 64
+    prev = 0
+    run = 0
+    for pixel in pixels:
+        if pixel == prev:
+            run += 1
+            if run == 62:
+                out.append(0xC0 | (run - 1))
+                run = 0
+            continue
+        if run:
+            out.append(0xC0 | (run - 1))
+            run = 0
+        h = hash_pixel(pixel)
+        if index[h] == pixel:
+            out.append(h)
+        else:
+            r, g, b = split(pixel)
+            pr, pg, pb = split(prev)
+            # Differences wrap around like the decoder's masking
+            dr = (r - pr + 16) % 32 - 16
+            dg = (g - pg + 32) % 64 - 32
+            db = (b - pb + 16) % 32 - 16
+            dr_dg = (dr - dg + 16) % 32 - 16
+            db_dg = (db - dg + 16) % 32 - 16
+            if -2 <= dr <= 1 and -2 <= dg <= 1 and -2 <= db <= 1:
+                out.append(0x40 | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2))
+            elif -8 <= dr_dg <= 7 and -8 <= db_dg <= 7:
+                out.append(0x80 | (dg + 32))
+                out.append(((dr_dg + 8) << 4) | (db_dg + 8))
+            else:
+                out.append(0xFE)
+                out += struct.pack("<H", pixel)
+            index[h] = pixel
+        prev = pixel
+    if run:
+        out.append(0xC0 | (run - 1))
+    return bytes(out)
+
+
+def pack_image(source, scales):
+    variants = [(scale,) + load_rgb565(source, scale) for scale in scales]
+    codes = [encode(pixels) for _, _, _, pixels in variants]
+    offset = 8 + 12 * len(variants)
+    data = bytearray(b"PIMG" + struct.pack("<BBH", VERSION, len(variants), 0))
+    for (scale, width, height, _), code in zip(variants, codes):
+        data += struct.pack("<BBHHHI", scale, 0, width, height, 0, offset)
+        offset += len(code)
+    for code in codes:
+        data += code
+    return bytes(data)
+
+
+def read_file(path):
+    if not os.path.exists(path):
+        return None
+    with open(path, "rb") as f:
+        return f.read()
+
+
+def have_pillow():
+    try:
+        import PIL  # noqa: F401
+        return True
+    except ImportError:
+        return False
+
+
+def parse_scales(option):
+    """custom_image_scales lines look like 'images/packed/WeatherWidget/ = 1 4', the longest matching prefix wins."""
+    scales = {}
+    for line in option.splitlines():
+        line = line.split(";")[0].strip()
+        if "=" in line:
+            prefix, values = line.split("=", 1)
+            scales[prefix.strip()] = sorted(set(int(v) for v in values.split()))
+    return scales
+
+
+def scales_for(target, scales):
+    best = ""
+    for prefix in scales:
+        if target.startswith(prefix) and len(prefix) > len(best):
+            best = prefix
+    return scales.get(best, [1])
+
+
+def build(targets, scales_option):
+    if not targets:
+        return
+    if not have_pillow():
+        sys.exit("pack_images: Pillow is required to convert the images (pip install -r tools/requirements.txt, see README)")
+    scales = parse_scales(scales_option)
+    jpeg_size = packed_size = 0
+    for target in targets:
+        source = os.path.join(ROOT, "images", target[len(PACKED_DIR):-len(".pimg")] + ".jpg")
+        data = pack_image(source, scales_for(target, scales))
+        target = os.path.join(ROOT, target)
+        # Don't touch unchanged images to avoid relinking the firmware
+        if read_file(target) != data:
+            os.makedirs(os.path.dirname(target), exist_ok=True)
+            with open(target, "wb") as f:
+                f.write(data)
+        jpeg_size += os.path.getsize(source)
+        packed_size += len(data)
+    print(f"pack_images: {len(targets)} images, {jpeg_size} bytes JPEG -> {packed_size} bytes packed")
+
+
+def embedded_images(embed_files):
+    files = [line.split(";")[0].strip() for line in embed_files.splitlines()]
+    return [f for f in files if f.startswith(PACKED_DIR) and f.endswith(".pimg")]
+
+
+def main():
+    config = configparser.ConfigParser(interpolation=None, inline_comment_prefixes=(";",))
+    config.read(os.path.join(ROOT, "platformio.ini"))
+    for section in config.sections():
+        if section.startswith("env:"):
+            files = config[section].get("board_build.embed_files", "") + "\n" + config[section].get("custom_assets", "")
+            build(embedded_images(files), config[section].get("custom_image_scales", ""))
+            return
+
+
+if __name__ == "__main__":
+    main()
+elif "Import" in globals():
+    # PlatformIO pre-script (no __file__ in SCons scripts), not when imported by another tool
+    Import("env")  # noqa: F821
+    ROOT = env.subst("$PROJECT_DIR")  # noqa: F821
+    files = env.GetProjectOption("board_build.embed_files", "") + "\n" + env.GetProjectOption("custom_assets", "")  # noqa: F821
+    build(embedded_images(files), env.GetProjectOption("custom_image_scales", ""))  # noqa: F821
@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+"""Subset the embedded TTF fonts to the characters the firmware can display.
+
+Every font in board_build.embed_files (or custom_assets) below fonts/subset/
+is generated from the full font with the same name in fonts/. The subset keeps
+printable ASCII, Latin-1, general punctuation, the currency symbols and every
+non-ASCII character found in the firmware sources (LOC_MONTH, LOC_WEEKDAY...).
+Add characters you need for data from the network (e.g. WebData) with
+custom_font_chars in platformio.ini.
+
+Layout tables (GSUB/GPOS/kern) are dropped because OpenFontRender doesn't use
+them, the TrueType hinting is kept so glyphs render exactly as before.
+
+Runs automatically as a PlatformIO pre-script, or manually:
+Usage: python3 tools/subset_fonts.py
+"""
+
+import configparser
+import io
+import logging
+import os
+import sys
+
+ROOT = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(sys.argv[0])), ".."))
+SUBSET_DIR = "fonts/subset/"
+SOURCE_DIRS = ("firmware/src", "firmware/config")
+
+BASE_RANGES = (
+    (0x0020, 0x007E),  # Printable ASCII
+    (0x00A0, 0x00FF),  # Latin-1 (°, £, ¥, umlauts, accents)
+    (0x2010, 0x2027),  # Dashes, quotes, bullet, ellipsis
+    (0x2030, 0x2030),  # Per mille
+    (0x20A0, 0x20C0),  # Currency symbols (€, ₹, ₿...)
+)
+
+
+def source_chars():
+    chars = set()
+    for source_dir in SOURCE_DIRS:
+        for root, _, files in os.walk(os.path.join(ROOT, source_dir)):
+            for name in files:
+                if name.endswith((".h", ".cpp", ".template")):
+                    with open(os.path.join(root, name), encoding="utf-8", errors="ignore") as f:
+                        chars.update(ord(c) for c in f.read() if ord(c) > 0x7F)
+    return chars
+
+
+def wanted_unicodes(extra_chars):
+    unicodes = set()
+    for first, last in BASE_RANGES:
+        unicodes.update(range(first, last + 1))
+    unicodes.update(source_chars())
+    unicodes.update(ord(c) for c in extra_chars)
+    return unicodes
+
+
+def subset_font(source, unicodes):
+    from fontTools import subset
+    from fontTools.ttLib import TTFont
+
+    logging.getLogger("fontTools").setLevel(logging.ERROR)
+
+    options = subset.Options()
+    options.layout_features = []
+    options.drop_tables += ["GSUB", "GPOS", "GDEF", "kern", "DSIG", "FFTM"]
+    options.glyph_names = False
+    options.name_IDs = [1, 2]
+    options.notdef_outline = True
+
+    # Keep the timestamps, so the output only changes when the subset does
+    font = TTFont(source, recalcTimestamp=False)
+    subsetter = subset.Subsetter(options)
+    subsetter.populate(unicodes=unicodes)
+    subsetter.subset(font)
+    data = io.BytesIO()
+    font.save(data)
+    return data.getvalue()
+
+
+def read_file(path):
+    if not os.path.exists(path):
+        return None
+    with open(path, "rb") as f:
+        return f.read()
+
+
+def have_fonttools():
+    try:
+        import fontTools  # noqa: F401
+        return True
+    except ImportError:
+        return False
+
+
+def build(targets, extra_chars):
+    if not targets:
+        return
+    if not have_fonttools():
+        sys.exit("subset_fonts: fontTools is required to subset the fonts (pip install -r tools/requirements.txt, see README)")
+    unicodes = wanted_unicodes(extra_chars)
+    for target in targets:
+        source = os.path.join(ROOT, "fonts", os.path.basename(target))
+        target = os.path.join(ROOT, target)
+        data = subset_font(source, unicodes)
+        # Don't touch unchanged fonts to avoid relinking the firmware
+        if read_file(target) != data:
+            os.makedirs(os.path.dirname(target), exist_ok=True)
+            with open(target, "wb") as f:
+                f.write(data)
+        print(f"subset_fonts: {os.path.relpath(target, ROOT)} {os.path.getsize(source)} -> {os.path.getsize(target)} bytes")
+
+
+def embedded_fonts(embed_files):
+    files = [line.split(";")[0].strip() for line in embed_files.splitlines()]
+    return [f for f in files if f.startswith(SUBSET_DIR) and f.endswith(".ttf")]
+
+
+def main():
+    config = configparser.ConfigParser(interpolation=None, inline_comment_prefixes=(";",))
+    config.read(os.path.join(ROOT, "platformio.ini"))
+    for section in config.sections():
+        if section.startswith("env:"):
+            files = config[section].get("board_build.embed_files", "") + "\n" + config[section].get("custom_assets", "")
+            build(embedded_fonts(files), config[section].get("custom_font_chars", ""))
+            return
+
+
+if __name__ == "__main__":
+    main()
+elif "Import" in globals():
+    # PlatformIO pre-script (no __file__ in SCons scripts), not when imported by tools/pack_assets.py
+    Import("env")  # noqa: F821
+    ROOT = env.subst("$PROJECT_DIR")  # noqa: F821
+    files = env.GetProjectOption("board_build.embed_files", "") + "\n" + env.GetProjectOption("custom_assets", "")  # noqa: F821
+    build(embedded_fonts(files), env.GetProjectOption("custom_font_chars", ""))  # noqa: F821